@@ -0,0 +1,635 @@
+//================================================================================
+// Name        : benchmark.cpp
+// Author      : agent
+// Version     : 1.0
+// Description : Benchmarks of the container library (Array, ArrayList,
+//               LinkedList, UnrolledLinkedList, SkipList, DList) in the style
+//               of Google Benchmark. Each benchmark performs one operation over
+//               n elements (add, insert at front, insert in the middle,
+//               remove(0), get(i) loop, traversal, find, copy, clear) for
+//               element types int, std::string and Transaction and n from 10
+//               to 10M. The baselines ArrayList FindByGet (get(i) by value)
+//               and LinkedList ClearByRemove (remove(i) loop) are timed next
+//               to Find and Clear. Results are printed as a table or as
+//               JSON/CSV to track regressions.
+//
+// Usage       : benchmark [--benchmark_filter=<regex>]
+//                         [--benchmark_min_time=<seconds>]
+//                         [--benchmark_max_size=<n>]
+//                         [--benchmark_max_quadratic_size=<n>]
+//                         [--benchmark_format=console|json|csv]
+//                         [--benchmark_out=<file>] [--benchmark_out_format=json|csv]
+//                         [--benchmark_list_tests]
+//================================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Array.h"
+#include "ArrayList.h"
+#include "LinkedList.h"
+#include "UnrolledLinkedList.h"
+#include "SkipList.h"
+#include "DList.h"
+#include "BlockChain.h"
+
+using namespace std;
+
+// ------------ Benchmark state, times the iterations of one run --------------
+// Used as:  while (state.keepRunning()) { ...operation... }
+// with pauseTiming/resumeTiming around per iteration setup and teardown.
+// Processor time is sampled only at the start and end of the run (reading it
+// costs far more than a steady_clock read) and shared between the timed and
+// paused regions in proportion to their wall clock time.
+class State {
+public:
+	State(long long iterations, int n) : iterations(iterations), n(n), done(0), running(false),
+		realSeconds(0), cpuSeconds(0), totalSeconds(0) {}
+
+	int range() const					{ return n; }
+	long long getIterations() const		{ return iterations; }
+	double getRealSeconds() const		{ return realSeconds; }
+	double getCpuSeconds() const		{ return (totalSeconds > 0) ? cpuSeconds * realSeconds / totalSeconds : 0; }
+
+	// PostCondition: returns true while iterations remain, timing runs from the first call
+	bool keepRunning() {
+		if (done == 0 && !running) {
+			cpuStart = clock();
+			runStart = chrono::steady_clock::now();
+			resumeTiming();
+		}
+		if (done == iterations) {
+			pauseTiming();
+			totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - runStart).count();
+			cpuSeconds = static_cast<double>(clock() - cpuStart) / CLOCKS_PER_SEC;
+			return false;
+		}
+		done++;
+		return true;
+	}
+
+	void pauseTiming() {
+		if (running) {
+			realSeconds += chrono::duration<double>(chrono::steady_clock::now() - realStart).count();
+			running = false;
+		}
+	}
+
+	void resumeTiming() {
+		if (!running) {
+			running = true;
+			realStart = chrono::steady_clock::now();
+		}
+	}
+
+private:
+	long long iterations;	// iterations to run
+	int n;					// number of elements processed per iteration
+	long long done;			// iterations started
+	bool running;			// timer running
+	chrono::steady_clock::time_point runStart;		// start of the run
+	chrono::steady_clock::time_point realStart;		// start of current timed region
+	clock_t cpuStart;		// processor time at start of the run
+	double realSeconds;		// wall clock time of timed regions
+	double cpuSeconds;		// processor time of the whole run
+	double totalSeconds;	// wall clock time of the whole run
+};
+
+// ------------ Keeps results alive so the optimiser cannot remove the work ---
+static volatile size_t sink;
+
+size_t checksum(int v)					{ return static_cast<size_t>(v); }
+size_t checksum(const string & s)		{ return s.size(); }
+size_t checksum(const Transaction & t)	{ return t.fromAddress.size(); }
+
+// ------------ Element values, strings are long enough to be heap allocated --
+template <class T> T makeValue(int i);
+
+template <> int makeValue<int>(int i) {
+	return i;
+}
+
+template <> string makeValue<string>(int i) {
+	return "wallet-address-" + to_string(i);
+}
+
+template <> Transaction makeValue<Transaction>(int i) {
+	return Transaction::fromCents(makeValue<string>(i), "recipient-wallet", i);
+}
+
+template <class T>
+vector<T> makeValues(int n) {
+	vector<T> values;
+	values.reserve(n);
+	for (int i = 0; i < n; i++) {
+		values.push_back(makeValue<T>(i));
+	}
+	return values;
+}
+
+// ------------ Uniform access to the containers ------------------------------
+// The Lists share the LinkedList interface, Array has its own overloads. Array has
+// no positional insert or remove, so those benchmarks are not registered for it
+template <class T> void append(Array<T> & c, const T & v)			{ c.emplaceBack(v); }
+template <class C, class T> void append(C & c, const T & v)			{ c.add(v); }
+
+template <class T> const T & element(const Array<T> & c, int i)		{ return c[i]; }
+template <class C> auto element(const C & c, int i) -> decltype(c.get(i)) { return c.get(i); }
+
+template <class T> int findIn(const Array<T> & c, const T & v) {
+	const T * p = find(c.begin(), c.end(), v);
+	return (p != c.end()) ? static_cast<int>(p - c.begin()) : -1;
+}
+template <class C, class T> int findIn(const C & c, const T & v)	{ return c.find(v); }
+
+template <class T> void clearAll(Array<T> & c)			{ c.resize(0); }
+template <class C> void clearAll(C & c)					{ c.clear(); }
+
+template <class C, class T>
+unique_ptr<C> makeContainer(const vector<T> & values) {
+	unique_ptr<C> c(new C());
+	for (const T & v : values) {
+		append(*c, v);
+	}
+	return c;
+}
+
+// ------------ The benchmarked operations, each over n elements -------------
+
+// add n elements to the end of an empty container
+template <class C, class T>
+void benchAdd(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		unique_ptr<C> c(new C());
+		for (const T & v : values) {
+			append(*c, v);
+		}
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// insert n elements, each at position 0
+template <class C, class T>
+void benchInsertFront(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		unique_ptr<C> c(new C());
+		for (const T & v : values) {
+			c->add(0, v);
+		}
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// insert n elements, each in the middle of the container
+template <class C, class T>
+void benchInsertMiddle(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		unique_ptr<C> c(new C());
+		for (const T & v : values) {
+			c->add(c->size() / 2, v);
+		}
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// remove(0) until a container of n elements is empty
+template <class C, class T>
+void benchRemoveFront(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		state.pauseTiming();
+		unique_ptr<C> c = makeContainer<C>(values);
+		state.resumeTiming();
+		while (!c->isEmpty()) {
+			c->remove(0);
+		}
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// get(i) for every position i
+template <class C, class T>
+void benchGetLoop(State & state) {
+	unique_ptr<C> c = makeContainer<C>(makeValues<T>(state.range()));
+	int n = state.range();
+	while (state.keepRunning()) {
+		size_t sum = 0;
+		for (int i = 0; i < n; i++) {
+			sum += checksum(element(*c, i));
+		}
+		sink = sink + sum;
+	}
+}
+
+// visit every element in order through the container iterators
+template <class C, class T>
+void benchTraverse(State & state) {
+	unique_ptr<C> c = makeContainer<C>(makeValues<T>(state.range()));
+	const C & elements = *c;
+	while (state.keepRunning()) {
+		size_t sum = 0;
+		for (const T & e : elements) {
+			sum += checksum(e);
+		}
+		sink = sink + sum;
+	}
+}
+
+// find a value that is not present (visits every element)
+template <class C, class T>
+void benchFind(State & state) {
+	unique_ptr<C> c = makeContainer<C>(makeValues<T>(state.range()));
+	T missing = makeValue<T>(-1);
+	while (state.keepRunning()) {
+		sink = sink + static_cast<size_t>(findIn(*c, missing));
+	}
+}
+
+// find a value that is not present by copying each element out with get(i),
+// the baseline the in place find is measured against
+template <class C, class T>
+void benchFindByGet(State & state) {
+	unique_ptr<C> c = makeContainer<C>(makeValues<T>(state.range()));
+	T missing = makeValue<T>(-1);
+	while (state.keepRunning()) {
+		int found = -1;
+		for (int i = 0; i < c->size(); i++) {
+			T e = c->get(i);
+			if (e == missing) {
+				found = i;
+				break;
+			}
+		}
+		sink = sink + static_cast<size_t>(found);
+	}
+}
+
+// copy construct a container of n elements
+template <class C, class T>
+void benchCopy(State & state) {
+	unique_ptr<C> c = makeContainer<C>(makeValues<T>(state.range()));
+	while (state.keepRunning()) {
+		unique_ptr<C> copy(new C(*c));
+		state.pauseTiming();
+		copy.reset();
+		state.resumeTiming();
+	}
+}
+
+// clear a container of n elements
+template <class C, class T>
+void benchClear(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		state.pauseTiming();
+		unique_ptr<C> c = makeContainer<C>(values);
+		state.resumeTiming();
+		clearAll(*c);
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// empty a container of n elements with remove(i) from the back, the baseline the
+// single pass clear is measured against
+template <class C, class T>
+void benchClearByRemove(State & state) {
+	vector<T> values = makeValues<T>(state.range());
+	while (state.keepRunning()) {
+		state.pauseTiming();
+		unique_ptr<C> c = makeContainer<C>(values);
+		state.resumeTiming();
+		for (int i = c->size() - 1; i >= 0; i--) {
+			c->remove(i);
+		}
+		state.pauseTiming();
+		c.reset();
+		state.resumeTiming();
+	}
+}
+
+// ------------ Registration of the benchmarks --------------------------------
+struct Benchmark {
+	string name;					// container<element>/operation/n
+	string container;
+	string element;
+	string operation;
+	int size;						// elements processed per iteration
+	function<void(State &)> run;
+};
+
+struct Options {
+	string filter = ".*";
+	double minTime = 0.5;					// seconds each benchmark is timed for
+	int maxSize = 10000000;					// largest n
+	int maxQuadraticSize = 10000;			// largest n of operations that are O(n^2)
+	string format = "console";
+	string out;								// file for machine readable results
+	string outFormat = "json";
+	bool list = false;
+};
+
+const int SIZES[] = { 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+
+// PostCondition: benchmark added for each size up to the limit of its complexity
+void registerOperation(vector<Benchmark> & benchmarks, const Options & options, const string & container,
+	const string & element, const string & operation, bool quadratic, function<void(State &)> run) {
+	int limit = quadratic ? min(options.maxSize, options.maxQuadraticSize) : options.maxSize;
+	for (int n : SIZES) {
+		if (n <= limit) {
+			string name = container + "<" + element + ">/" + operation + "/" + to_string(n);
+			benchmarks.push_back(Benchmark{ name, container, element, operation, n, run });
+		}
+	}
+}
+
+// PostCondition: benchmarks of the LinkedList interface added for List C, the operations
+//                named in quadratic repeat an O(n) step n times so are limited in size
+template <class C, class T>
+void registerList(vector<Benchmark> & benchmarks, const Options & options, const string & container,
+	const string & element, const vector<string> & quadratic) {
+	auto add = [&](const string & operation, function<void(State &)> run) {
+		bool isQuadratic = find(quadratic.begin(), quadratic.end(), operation) != quadratic.end();
+		registerOperation(benchmarks, options, container, element, operation, isQuadratic, run);
+	};
+	add("Add", benchAdd<C, T>);
+	add("InsertFront", benchInsertFront<C, T>);
+	add("InsertMiddle", benchInsertMiddle<C, T>);
+	add("RemoveFront", benchRemoveFront<C, T>);
+	add("GetLoop", benchGetLoop<C, T>);
+	add("Traverse", benchTraverse<C, T>);
+	add("Find", benchFind<C, T>);
+	add("Copy", benchCopy<C, T>);
+	add("Clear", benchClear<C, T>);
+}
+
+// PostCondition: benchmarks of every operation of each container with element type T added,
+//                quadratic operations (those repeating an O(n) step n times) are limited
+template <class T>
+void registerContainers(vector<Benchmark> & benchmarks, const Options & options, const string & element) {
+	registerOperation(benchmarks, options, "Array", element, "Add", false, benchAdd<Array<T>, T>);
+	registerOperation(benchmarks, options, "Array", element, "GetLoop", false, benchGetLoop<Array<T>, T>);
+	registerOperation(benchmarks, options, "Array", element, "Traverse", false, benchTraverse<Array<T>, T>);
+	registerOperation(benchmarks, options, "Array", element, "Find", false, benchFind<Array<T>, T>);
+	registerOperation(benchmarks, options, "Array", element, "Copy", false, benchCopy<Array<T>, T>);
+	registerOperation(benchmarks, options, "Array", element, "Clear", false, benchClear<Array<T>, T>);
+
+	registerList<ArrayList<T>, T>(benchmarks, options, "ArrayList", element, { "InsertFront", "InsertMiddle", "RemoveFront" });
+	registerOperation(benchmarks, options, "ArrayList", element, "FindByGet", false, benchFindByGet<ArrayList<T>, T>);
+	registerList<LinkedList<T>, T>(benchmarks, options, "LinkedList", element, { "InsertMiddle", "GetLoop" });
+	registerOperation(benchmarks, options, "LinkedList", element, "ClearByRemove", true, benchClearByRemove<LinkedList<T>, T>);
+	registerList<UnrolledLinkedList<T>, T>(benchmarks, options, "UnrolledLinkedList", element, { "InsertMiddle", "GetLoop" });
+	registerList<SkipList<T>, T>(benchmarks, options, "SkipList", element, {});
+	registerList<DList<T>, T>(benchmarks, options, "DList", element, { "InsertMiddle", "GetLoop" });
+}
+
+// ------------ Running and reporting -----------------------------------------
+struct Result {
+	const Benchmark * benchmark;
+	long long iterations;
+	double realNs;		// wall clock time per iteration
+	double cpuNs;		// processor time per iteration
+
+	double itemsPerSecond() const {
+		return (realNs > 0) ? benchmark->size * 1e9 / realNs : 0;
+	}
+};
+
+// PostCondition: benchmark run with growing iteration counts until it has been
+//                timed for at least minTime seconds, the final run is returned
+Result runBenchmark(const Benchmark & b, double minTime) {
+	long long iterations = 1;
+	while (true) {
+		State state(iterations, b.size);
+		b.run(state);
+		double seconds = state.getRealSeconds();
+		if (seconds >= minTime || iterations >= 1000000000) {
+			return Result{ &b, iterations, seconds * 1e9 / iterations, state.getCpuSeconds() * 1e9 / iterations };
+		}
+		// predict iterations needed, growing at most 10 times per attempt
+		double multiplier = (seconds > 0) ? minTime * 1.4 / seconds : 10;
+		multiplier = min(10.0, max(2.0, multiplier));
+		iterations = static_cast<long long>(iterations * multiplier);
+	}
+}
+
+// PostCondition: returns s with JSON special characters escaped
+string jsonEscape(const string & s) {
+	string escaped;
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+// PostCondition: returns rate in the units of Google Benchmark (k, M, G per second)
+string humanRate(double rate) {
+	const char * units[] = { "", "k", "M", "G" };
+	int u = 0;
+	while (rate >= 1000 && u < 3) {
+		rate /= 1000;
+		u++;
+	}
+	stringstream ss;
+	ss << fixed << setprecision(rate < 10 ? 2 : 1) << rate << units[u] << "/s";
+	return ss.str();
+}
+
+void printConsoleHeader(ostream & os) {
+	os << "Run on (" << thread::hardware_concurrency() << " X CPU)\n";
+#ifndef NDEBUG
+	os << "***WARNING*** Library was built as DEBUG. Timings may be affected.\n";
+#endif
+	os << string(96, '-') << "\n";
+	os << left << setw(44) << "Benchmark" << right << setw(15) << "Time" << setw(15) << "CPU"
+		<< setw(12) << "Iterations" << setw(10) << "Items" << "\n";
+	os << string(96, '-') << "\n";
+}
+
+void printConsole(ostream & os, const Result & r) {
+	os << left << setw(44) << r.benchmark->name << right << fixed << setprecision(0)
+		<< setw(12) << r.realNs << " ns" << setw(12) << r.cpuNs << " ns"
+		<< setw(12) << r.iterations << "  " << humanRate(r.itemsPerSecond()) << "\n" << flush;
+}
+
+void printCsvHeader(ostream & os) {
+	os << "name,container,element,operation,size,iterations,real_time,cpu_time,time_unit,items_per_second\n";
+}
+
+void printCsv(ostream & os, const Result & r) {
+	const Benchmark & b = *r.benchmark;
+	os << "\"" << b.name << "\"," << b.container << "," << b.element << "," << b.operation << "," << b.size
+		<< "," << r.iterations << "," << setprecision(6) << defaultfloat << r.realNs << "," << r.cpuNs
+		<< ",ns," << r.itemsPerSecond() << "\n" << flush;
+}
+
+// PostCondition: results written in the JSON layout of Google Benchmark
+void printJson(ostream & os, const vector<Result> & results, const string & executable) {
+	time_t now = time(nullptr);
+	char date[32];
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	os << "{\n  \"context\": {\n"
+		<< "    \"date\": \"" << date << "\",\n"
+		<< "    \"executable\": \"" << jsonEscape(executable) << "\",\n"
+		<< "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+		<< "    \"library_build_type\": \"release\"\n"
+#else
+		<< "    \"library_build_type\": \"debug\"\n"
+#endif
+		<< "  },\n  \"benchmarks\": [";
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result & r = results[i];
+		const Benchmark & b = *r.benchmark;
+		os << (i == 0 ? "\n" : ",\n") << "    {\n"
+			<< "      \"name\": \"" << jsonEscape(b.name) << "\",\n"
+			<< "      \"container\": \"" << b.container << "\",\n"
+			<< "      \"element\": \"" << b.element << "\",\n"
+			<< "      \"operation\": \"" << b.operation << "\",\n"
+			<< "      \"size\": " << b.size << ",\n"
+			<< "      \"iterations\": " << r.iterations << ",\n"
+			<< setprecision(6) << defaultfloat
+			<< "      \"real_time\": " << r.realNs << ",\n"
+			<< "      \"cpu_time\": " << r.cpuNs << ",\n"
+			<< "      \"time_unit\": \"ns\",\n"
+			<< "      \"items_per_second\": " << r.itemsPerSecond() << "\n"
+			<< "    }";
+	}
+	os << "\n  ]\n}\n";
+}
+
+// PostCondition: returns true if arg is --name=value, value set to the text after =
+bool parseFlag(const string & arg, const string & name, string & value) {
+	string prefix = "--" + name + "=";
+	if (arg.compare(0, prefix.size(), prefix) == 0) {
+		value = arg.substr(prefix.size());
+		return true;
+	}
+	return false;
+}
+
+int main(int argc, char * argv[]) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i], value;
+		if (parseFlag(arg, "benchmark_filter", value)) {
+			options.filter = value;
+		}
+		else if (parseFlag(arg, "benchmark_min_time", value)) {
+			options.minTime = stod(value);
+		}
+		else if (parseFlag(arg, "benchmark_max_size", value)) {
+			options.maxSize = stoi(value);
+		}
+		else if (parseFlag(arg, "benchmark_max_quadratic_size", value)) {
+			options.maxQuadraticSize = stoi(value);
+		}
+		else if (parseFlag(arg, "benchmark_format", value)) {
+			options.format = value;
+		}
+		else if (parseFlag(arg, "benchmark_out", value)) {
+			options.out = value;
+		}
+		else if (parseFlag(arg, "benchmark_out_format", value)) {
+			options.outFormat = value;
+		}
+		else if (arg == "--benchmark_list_tests") {
+			options.list = true;
+		}
+		else {
+			cerr << "benchmark: unknown argument " << arg << "\n";
+			return 1;
+		}
+	}
+	if ((options.format != "console" && options.format != "json" && options.format != "csv") ||
+		(options.outFormat != "json" && options.outFormat != "csv")) {
+		cerr << "benchmark: unknown format\n";
+		return 1;
+	}
+
+	vector<Benchmark> all;
+	registerContainers<int>(all, options, "int");
+	registerContainers<string>(all, options, "string");
+	registerContainers<Transaction>(all, options, "Transaction");
+
+	regex filter(options.filter);
+	vector<const Benchmark *> selected;
+	for (const Benchmark & b : all) {
+		if (regex_search(b.name, filter)) {
+			selected.push_back(&b);
+		}
+	}
+	if (options.list) {
+		for (const Benchmark * b : selected) {
+			cout << b->name << "\n";
+		}
+		return 0;
+	}
+
+	// console and csv results are printed as each benchmark completes
+	if (options.format == "console") {
+		printConsoleHeader(cout);
+	}
+	else if (options.format == "csv") {
+		printCsvHeader(cout);
+	}
+	vector<Result> results;
+	for (const Benchmark * b : selected) {
+		results.push_back(runBenchmark(*b, options.minTime));
+		if (options.format == "console") {
+			printConsole(cout, results.back());
+		}
+		else if (options.format == "csv") {
+			printCsv(cout, results.back());
+		}
+	}
+	if (options.format == "json") {
+		printJson(cout, results, argv[0]);
+	}
+
+	if (!options.out.empty()) {
+		ofstream file(options.out);
+		if (!file) {
+			cerr << "benchmark: cannot write " << options.out << "\n";
+			return 1;
+		}
+		if (options.outFormat == "csv") {
+			printCsvHeader(file);
+			for (const Result & r : results) {
+				printCsv(file, r);
+			}
+		}
+		else {
+			printJson(file, results, argv[0]);
+		}
+	}
+	return 0;
+}
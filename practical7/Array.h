@@ -5,7 +5,7 @@
  *
  * @author  Aiden McCaughey
  * @email   a.mccaughey@ulster.ac.uk
- * @version 1.3
+ * @version 1.4
  */
 
 #ifndef ARRAY_H_
@@ -14,6 +14,10 @@
 #include <exception>
 #include <cassert>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 
 template <class T>
@@ -24,24 +28,43 @@ public:
 	~Array();
 	
 	Array(const Array<T> & ap);
+	Array(Array<T> && ap) noexcept;
 	Array(int size, const int *data);
 	
 	Array<T>& operator=(const Array<T> & right);
+	Array<T>& operator=(Array<T> && right) noexcept;
 	
 	T& operator[](int index);
 	const T& operator[](int index) const;
 	int length() const;
+	int capacity() const;
+
+	// Unchecked access to the contiguous elements
+	T* data()					{ return elements; }
+	const T* data() const		{ return elements; }
+	T* begin()					{ return elements; }
+	T* end()					{ return elements + used; }
+	const T* begin() const		{ return elements; }
+	const T* end() const		{ return elements + used; }
 	
 	void resize(int newSize);
+	void reserve(int newCapacity);
+	void shrink_to_fit();
+	template <class... Args> T& emplaceBack(Args&&... args);
+	void popBack();
 	void initialise(T def=T());
 	void print(std::ostream & os=std::cout) const;
 	std::string toString() const;
 
 private:
-	T *elements;
-	int capacity;
+	T *elements;	// uninitialised storage, only the first used elements are constructed
+	int used;		// number of constructed elements (the length)
+	int allocated;	// number of elements storage has room for
 
 	inline void deepCopy(const Array<T> & original);
+	void reallocate(int newCapacity);
+	void destroy();
+	static T* allocate(int n)	{ return (n > 0) ? static_cast<T*>(::operator new(sizeof(T) * n)) : nullptr; }
 };
 
 
@@ -55,8 +78,11 @@ Array<T>::Array(int size)
 	if (size < 0) {
 		size = 0;
 	}
-	capacity = size;
-	elements = new T[capacity];
+	elements = allocate(size);
+	allocated = size;
+	for (used = 0; used < size; used++) {
+		new (&elements[used]) T();
+	}
 }
 
 // PreCondition: None
@@ -64,9 +90,20 @@ Array<T>::Array(int size)
 template <class T>
 Array<T>::~Array()
 {
-	delete [] elements;
+	destroy();
+}
+
+// PreCondition: None
+// PostCondition: elements destroyed and storage returned to the heap, array is empty
+template <class T>
+void Array<T>::destroy()
+{
+	for (int i = 0; i < used; i++) {
+		elements[i].~T();
+	}
+	::operator delete(elements);
 	elements = nullptr;
-	capacity = 0;
+	used = allocated = 0;
 }
 
 // PreCondition: ap is a valid Array
@@ -77,6 +114,15 @@ Array<T>::Array(const Array<T> & ap)
 	deepCopy(ap);
 }
 
+// PreCondition: ap is a valid Array
+// PostCondition: Initalises new Array by taking over the elements of ap, ap is left empty
+template <class T>
+Array<T>::Array(Array<T> && ap) noexcept : elements{ ap.elements }, used{ ap.used }, allocated{ ap.allocated }
+{
+	ap.elements = nullptr;
+	ap.used = ap.allocated = 0;
+}
+
 // PreCondition: a is a C array
 // PostCondition: Initalises new Array with values contained in array data
 template <class T>
@@ -86,13 +132,13 @@ Array<T>::Array(int size, const int *data)
 	if (size < 0) {
 		size = 0;
 	}
-	capacity = size;
-	elements = new T[capacity];
+	elements = allocate(size);
+	allocated = size;
 
 	// populate the Array with supplied data
-	for (int i = 0; i < size; i++)
+	for (used = 0; used < size; used++)
 	{
-		elements[i] = data[i];
+		new (&elements[used]) T(data[used]);
 	}
 }
 
@@ -103,17 +149,33 @@ template <class T>
 Array<T> & Array<T>::operator=(const Array<T> & right)
 {
 	if (this != &right) {
-		delete [] elements;
+		destroy();
 		deepCopy(right);
 	}
 	return *this;
 }
 
+// PreCondition: None
+// PostCondition: elements of right are moved into this, right is left empty
+template <class T>
+Array<T> & Array<T>::operator=(Array<T> && right) noexcept
+{
+	if (this != &right) {
+		destroy();
+		elements = right.elements;
+		used = right.used;
+		allocated = right.allocated;
+		right.elements = nullptr;
+		right.used = right.allocated = 0;
+	}
+	return *this;
+}
+
 // PreCondition: None
 // PostCondition: each position in array is initialised with def value
 template <class T>
 void Array<T>::initialise(T def) {
-	for(int i=0; i<capacity; i++)
+	for(int i=0; i<used; i++)
 		elements[i] = def;
 }
 
@@ -123,11 +185,10 @@ void Array<T>::initialise(T def) {
 template <class T>
 void Array<T>::deepCopy(const Array<T> & original)
 {
-	capacity = original.capacity;
-
-	elements = new T[capacity];
-	for (int i=0; i<capacity; i++) {
-		elements[i] = original.elements[i];
+	elements = allocate(original.used);
+	allocated = original.used;
+	for (used = 0; used < original.used; used++) {
+		new (&elements[used]) T(original.elements[used]);
 	}
 }
 
@@ -136,7 +197,7 @@ void Array<T>::deepCopy(const Array<T> & original)
 template <class T>
 T& Array<T>::operator[](int index)
 {
-	if (index < 0 || index >= capacity) {
+	if (index < 0 || index >= used) {
 		throw std::out_of_range("Array: index out of range " + std::to_string(index));
 	}
 	
@@ -148,31 +209,98 @@ T& Array<T>::operator[](int index)
 template <class T>
 const T& Array<T>::operator[](int index) const
 {
-	if (index < 0 || index >= capacity) {
+	if (index < 0 || index >= used) {
 		throw std::out_of_range("Array: index out of range " + std::to_string(index));
 	}
 	
 	return elements[index];
 }
 
-// PreCondition: newSize is greater than 0
-// PostCondition: array is resized
+// PreCondition: newCapacity >= length()
+// PostCondition: elements moved to new storage with room for newCapacity elements
 template <class T>
-void Array<T>::resize(int newSize) 
+void Array<T>::reallocate(int newCapacity)
 {
-	if (newSize > 0) {
-		auto *newArray = new T[newSize];
-		int limit = (newSize > capacity) ? capacity : newSize;
+	T *newArray = allocate(newCapacity);
+	for (int i = 0; i < used; i++) {
+		new (&newArray[i]) T(std::move(elements[i]));
+		elements[i].~T();
+	}
+	::operator delete(elements);
+	elements = newArray;
+	allocated = newCapacity;
+}
 
-		// copy existing elements to new array
-		for(int i=0; i<limit; i++) {
-			newArray[i] = elements[i];
+// PreCondition: newSize >= 0
+// PostCondition: array is resized, new elements are default constructed and
+//                elements beyond newSize destroyed
+template <class T>
+void Array<T>::resize(int newSize) 
+{
+	if (newSize >= 0) {
+		if (newSize > allocated) {
+			reallocate(newSize);
+		}
+		for (; used < newSize; used++) {
+			new (&elements[used]) T();
 		}
+		for (; used > newSize; used--) {
+			elements[used - 1].~T();
+		}
+	}	
+}
+
+// PostCondition: storage has room for at least newCapacity elements, length unchanged
+template <class T>
+void Array<T>::reserve(int newCapacity)
+{
+	if (newCapacity > allocated) {
+		reallocate(newCapacity);
+	}
+}
 
-		delete [] elements;
+// PostCondition: storage reduced to hold exactly length() elements
+template <class T>
+void Array<T>::shrink_to_fit()
+{
+	if (allocated > used) {
+		reallocate(used);
+	}
+}
+
+// PostCondition: element constructed from args at end of array, storage doubled when full
+template <class T>
+template <class... Args>
+T& Array<T>::emplaceBack(Args&&... args)
+{
+	if (used == allocated) {
+		// construct new element first as args may refer to an existing element
+		int newCapacity = (allocated > 0) ? allocated * 2 : 1;
+		T *newArray = allocate(newCapacity);
+		new (&newArray[used]) T(std::forward<Args>(args)...);
+		for (int i = 0; i < used; i++) {
+			new (&newArray[i]) T(std::move(elements[i]));
+			elements[i].~T();
+		}
+		::operator delete(elements);
 		elements = newArray;
-		capacity = newSize;
-	}	
+		allocated = newCapacity;
+	}
+	else {
+		new (&elements[used]) T(std::forward<Args>(args)...);
+	}
+	return elements[used++];
+}
+
+// PreCondition: length() > 0
+// PostCondition: last element destroyed
+template <class T>
+void Array<T>::popBack()
+{
+	if (used == 0) {
+		throw std::out_of_range("Array: popBack on empty array");
+	}
+	elements[--used].~T();
 }
 
 // PreCondition: None
@@ -180,9 +308,17 @@ void Array<T>::resize(int newSize)
 template <class T>
 inline int Array<T>::length() const
 {
-	return capacity;
+	return used;
 } 
 
+// PreCondition: None
+// PostCondition: Returns number of elements storage has room for
+template <class T>
+inline int Array<T>::capacity() const
+{
+	return allocated;
+}
+
 // PreCondition: None
 // PostCondition: prints a copy of array to ostream
 template <class T>
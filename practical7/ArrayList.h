@@ -6,7 +6,7 @@
 
  * @author  Aiden McCaughey
  * @email   a.mccaughey@ulster.ac.uk
- * @version 1.2
+ * @version 1.3
  */
 
 #ifndef ARRAYLIST_H
@@ -15,27 +15,44 @@
 #include "Array.h"
 #include <exception>
 #include <iostream>
+#include <utility>
 
 template <class T>
 class ArrayList {
 public:
 	explicit ArrayList(int size=100);
 	ArrayList(const ArrayList<T> & other);
-	void operator=(const ArrayList<T> & other);
+	ArrayList(ArrayList<T> && other) noexcept;
+	ArrayList<T> & operator=(const ArrayList<T> & other);
+	ArrayList<T> & operator=(ArrayList<T> && other) noexcept;
 	
 	bool operator==(const ArrayList<T> & other) const;
 	bool operator!=(const ArrayList<T> & other) const;
 
 	void clear();
 	void add(const T & value);
+	void add(T && value);
 	void add(int pos, const T & value);
+	void add(int pos, T && value);
+	template <class... Args> void emplace(Args&&... args);
 	void remove(int pos);
 	void set(int pos, const T & value);
-	T    get(int pos) const;
+	const T & get(int pos) const;
 	int  find(const T & value) const;
 
+	// Unchecked access to the contiguous elements, valid until the ArrayList is modified
+	T* data()					{ return items.data(); }
+	const T* data() const		{ return items.data(); }
+	T* begin()					{ return items.begin(); }
+	T* end()					{ return items.end(); }
+	const T* begin() const		{ return items.begin(); }
+	const T* end() const		{ return items.end(); }
+
 	int  size() const;
 	bool isEmpty() const;
+	int  capacity() const;
+	void reserve(int n);
+	void shrink_to_fit();
 	void print(std::ostream & os) const;
    
 	// Immutable List processing functions
@@ -47,26 +64,41 @@ public:
 	ArrayList<T> mid(int start, int count) const;
 	
 private:
-	Array<T> data;
-	int count;
+	Array<T> items;	// elements of the ArrayList, items.length() is the number of elements
+
+	template <class V> void insert(int pos, V && value);
 };
 
 // --------------- ArrayList Implementation -----------------------
 
-// Default Constructor
+// Default Constructor, reserves room for size elements without constructing them
 template <class T>
-ArrayList<T>::ArrayList(int size) : data(size), count{ 0 } {}
+ArrayList<T>::ArrayList(int size) : items() {
+	items.reserve(size);
+}
 
 // PostCondition: construct ArrayList as a duplicate of c
 template <class T>
-ArrayList<T>::ArrayList(const ArrayList<T> & other): data(other.data), count(other.count) {}
+ArrayList<T>::ArrayList(const ArrayList<T> & other): items(other.items) {}
+
+// PostCondition: construct ArrayList by taking over the elements of other, other is left empty
+template <class T>
+ArrayList<T>::ArrayList(ArrayList<T> && other) noexcept : items(std::move(other.items)) {}
 
 // PostCondition: assign c to ArrayList
 template<class T>
-void ArrayList<T>::operator=(const ArrayList<T> & other) 
+ArrayList<T> & ArrayList<T>::operator=(const ArrayList<T> & other) 
 {
-	data = other.data;
-	count = other.count;
+	items = other.items;
+	return *this;
+}
+
+// PostCondition: elements of other moved into ArrayList, other is left empty
+template<class T>
+ArrayList<T> & ArrayList<T>::operator=(ArrayList<T> && other) noexcept
+{
+	items = std::move(other.items);
+	return *this;
 }
 
 
@@ -74,16 +106,16 @@ void ArrayList<T>::operator=(const ArrayList<T> & other)
 template <class T>
 bool ArrayList<T>::operator==(const ArrayList<T> & other) const 
 {
-	bool same=true;
 	if (size() != other.size()) {
-		same = false;
+		return false;
 	}
-	for(int i=0; same && i<size(); i++) {
-		if (get(i) != other.get(i)) {
-			same = false;
+	const T * o = other.begin();
+	for (const T & e : *this) {
+		if (e != *o++) {
+			return false;
 		}
-	} 
-    return same;
+	}
+	return true;
 }
 
 // PostCondition: returns true if ArrayLists are not equal, false otherwise
@@ -96,34 +128,63 @@ bool ArrayList<T>::operator!=(const ArrayList<T> & other) const
 // PostCondition: return length of ArrayList
 template<class T>
 int ArrayList<T>::size() const {
-	return count;
+	return items.length();
 }
 
-// PreCondition: pos is a valid ArrayList position and ArrayList is not full
-// PostCondition: inserts element value at specified position in ArrayList
+// PostCondition: returns number of elements the ArrayList can hold before growing
 template<class T>
-void ArrayList<T>::add(int pos, const T & value) {
+int ArrayList<T>::capacity() const {
+	return items.capacity();
+}
+
+// PostCondition: room for at least n elements, existing elements are moved not copied
+template<class T>
+void ArrayList<T>::reserve(int n) {
+	items.reserve(n);
+}
+
+// PostCondition: unused capacity released
+template<class T>
+void ArrayList<T>::shrink_to_fit() {
+	items.shrink_to_fit();
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: value inserted at pos, storage doubles when full
+template<class T>
+template<class V>
+void ArrayList<T>::insert(int pos, V && value) {
+	int count = size();
 	if (pos < 0 || pos > count) {
 		throw std::out_of_range("ArrayList: invalid postion: " + std::to_string(pos));
 	}
-	// either throw execption if no room left in list
-	//if (count >= data.length()) 
-	//	throw std::overflow_error("ArrayList: overflow");
-  
-	// or increase size of ArrayList if required
-	if (count >= data.length()) {
-		data.resize(data.length() * 2);
+	if (pos == count) {
+		items.emplaceBack(std::forward<V>(value));
+		return;
 	}
-	// make room for new element
-	for (int i = count; i > pos; i--) {
-		data[i] = data[i - 1];
+	// take value first as it may refer to an element about to move
+	T element(std::forward<V>(value));
+
+	// make room for new element by moving elements up one place
+	items.emplaceBack(std::move(items[count - 1]));
+	for (int i = count - 1; i > pos; i--) {
+		items[i] = std::move(items[i - 1]);
 	}
+	items[pos] = std::move(element);
+}
 
-	// insert element in position
-	data[pos] = value;
+// PreCondition: pos is a valid ArrayList position
+// PostCondition: inserts element value at specified position in ArrayList
+template<class T>
+void ArrayList<T>::add(int pos, const T & value) {
+	insert(pos, value);
+}
 
-	// increment number of items in ArrayList
-	count++;
+// PreCondition: pos is a valid ArrayList position
+// PostCondition: moves value into specified position in ArrayList
+template<class T>
+void ArrayList<T>::add(int pos, T && value) {
+	insert(pos, std::move(value));
 }
 
 // PreCondition: ArrayList is not full
@@ -133,47 +194,62 @@ void ArrayList<T>::add(const T & value) {
 	add(size(), value);
 }
 
+// PostCondition: value moved to end of ArrayList
+template<class T>
+void ArrayList<T>::add(T && value) {
+	add(size(), std::move(value));
+}
+
+// PostCondition: element constructed in place from args at end of ArrayList
+template<class T>
+template<class... Args>
+void ArrayList<T>::emplace(Args&&... args) {
+	items.emplaceBack(std::forward<Args>(args)...);
+}
+
 // PreCondition: pos is a valid ArrayList position
 // PostCondition: remove element at specified position in  ArrayList
 template<class T>
 void ArrayList<T>::remove(int pos) {
+	int count = size();
 	if (pos < 0 || pos >= count) {
 		throw std::out_of_range("ArrayList: invalid postion: " + std::to_string(pos));
 	}
 	// fill gap by moving elements down
 	for (int i = pos; i < count - 1; i++) {
-		data[i] = data[i + 1];
+		items[i] = std::move(items[i + 1]);
 	}
-	count--; // decrease length
+	items.popBack(); // decrease length
 }
 
 // PreCondition: pos is a valid ArrayList position
-// PostCondition: retrieves element at specified position in ArrayList
+// PostCondition: returns reference to element at specified position in ArrayList
 template<class T>
-T ArrayList<T>::get(int pos) const  {
-	if (pos < 0 || pos >= count) {
+const T & ArrayList<T>::get(int pos) const  {
+	if (pos < 0 || pos >= size()) {
 		throw std::out_of_range("ArrayList: invalid postion: " + std::to_string(pos));
 	}
-	return data[pos]; 
+	return items[pos]; 
 }
 
 // PreCondition: pos is a valid ArrayList position
 // PostCondition: updates element at specified position in ArrayList
 template<class T>
 void ArrayList<T>::set(int pos, const T & value) {
-	if (pos < 0 || pos >= count) {
+	if (pos < 0 || pos >= size()) {
 		throw std::out_of_range("ArrayList: invalid postion: " + std::to_string(pos));
 	}
-	data[pos] = value;
+	items[pos] = value;
 }
 
 
 // PostCondition: returns postion of e in ArrayList or -1 if not found
 template<class T>
 int ArrayList<T>::find(const T & value) const {
-	for(int i=0; i<size(); i++) {
-		if (get(i) == value) {
-			return i;
+	const T * first = begin();
+	for (const T * p = first; p != end(); p++) {
+		if (*p == value) {
+			return static_cast<int>(p - first);
 		}
 	}
 	return -1;
@@ -184,30 +260,30 @@ int ArrayList<T>::find(const T & value) const {
 template<class T>
 void ArrayList<T>::print(std::ostream & os) const {
 	os << "[ ";
-	for(int i = 0; i < size(); i++) {
-		os << get(i) << " ";
+	for (const T & e : *this) {
+		os << e << " ";
 	}
 	os << "]";
 }
 
-// PostCondition: ArrayList is emptied len == 0;
+// PostCondition: ArrayList is emptied len == 0, capacity is kept
 template<class T>
 void ArrayList<T>::clear() {
-	count = 0;				// reset length to zero
+	items.resize(0);			// destroy elements, reset length to zero
 }
 
 //PostCondition: returns length of ArrayList
 template<class T>
 bool ArrayList<T>::isEmpty() const {
-	return (count == 0);
+	return (size() == 0);
 }
 
 template<class T>
 ArrayList<T> ArrayList<T>::reverse() const
 {
 	ArrayList<T> r(size());
-	for (int i = size()-1; i >= 0; i--) {
-		r.add(get(i));
+	for (const T * p = end(); p != begin(); ) {
+		r.add(*--p);
 	}
 	return r;
 }
@@ -219,8 +295,8 @@ ArrayList<T> ArrayList<T>::take(int n) const
 		throw std::out_of_range("ArrayList: invalid number of elements to take: " + std::to_string(n));
 	}
 	ArrayList<T> t(n);
-	for (int i = 0; i < n; i++) {
-		t.add(get(i));
+	for (const T * p = begin(); p != begin() + n; p++) {
+		t.add(*p);
 	}
 	return t;
 }
@@ -233,8 +309,8 @@ ArrayList<T> ArrayList<T>::drop(int n) const
 	}
 //	return mid(n, size()-n); // drop(2) [1,2,3]
 	ArrayList<T> d(size()-n);
-	for (int i = n; i < size(); i++) {
-		d.add(get(i));
+	for (const T * p = begin() + n; p != end(); p++) {
+		d.add(*p);
 	}
 	return d;
 }
@@ -243,11 +319,11 @@ template<class T>
 ArrayList<T> ArrayList<T>::concat(const ArrayList<T> & other) const
 {
 	ArrayList<T> n(size() + other.size());
-	for (int i = 0; i < size(); i++) {
-		n.add(get(i));
+	for (const T & e : *this) {
+		n.add(e);
 	}
-	for (int i = 0; i < other.size(); i++) {
-		n.add(other.get(i));
+	for (const T & e : other) {
+		n.add(e);
 	}
 	return n;
 }
@@ -4,8 +4,21 @@
 * Simple Implementation of a BlockChain
 *
 * Used to demonstrate use of:
-* Dynamic List class (LinkedList) used to implement the Chain
+* Random access List class (SegmentedList) used to implement the Chain
 * Static  List class (ArrayList)  used to implement a Block
+*
+* Once setConcurrentReaders(true) has been called, readers (getBalanceOfAddress,
+* getBalances, isChainValid, verifyBalances and toString) may run on any number
+* of threads while one thread mines. Blocks are published by the SegmentedList
+* size and the ledger index is replaced read-copy-update style, copying only
+* the shards of the index a block changes. Without it the ledger is updated in
+* place, read without hazard pointers, and readers must not overlap
+* minerGenerateBlock.
+* Everything else (pending transactions, getLastMiningResult, the store)
+* belongs to the mining thread.
+*
+* A chain saved with openStore can be inspected read only through a ChainView,
+* which reads blocks in place from the store without copying them.
 
 * @author  Aiden McCaughey
 * @email   a.mccaughey@ulster.ac.uk
@@ -13,86 +26,200 @@
 */
 
 #include "ArrayList.h"	// Static List
-#include "LinkedList.h"	// Dynamic List
+#include "SegmentedList.h"	// Random access List with stable element addresses
+#include "Mempool.h"	// pool of pending transactions
+#include "ConcurrentQueue.h"	// lock-free inbox of submitted transactions
 #include "picosha2.h"	// SHA256 hash algorithm
+#include "Miner.h"		// multithreaded proof of work
+#include "Encoding.h"	// binary encoding of blocks
+#include "BlockStore.h"	// persistent block storage
+#include "BlockView.h"	// blocks read in place from the store
+#include "ChainWriter.h"	// streamed output of blocks
 
 #include <sstream>		// std::stringstream
-#include <iomanip>      // std::setprecision
 #include <ctime>		// std::time
+#include <algorithm>	// std::min_element
+#include <thread>		// std::thread
+#include <unordered_map>	// std::unordered_map
+#include <atomic>		// std::atomic
+#include <vector>		// std::vector
+#include <cstdint>		// std::int64_t
+#include <memory>		// std::unique_ptr, std::shared_ptr
+#include <functional>	// std::hash
+#include <string_view>	// std::string_view
 
 //  -------- A Transaction recording transfer of money from sender to recipient ------ //
+// The amount is held in cents so balances add up exactly, it is only shown with a
+// decimal point when printed
 struct Transaction {
-	Transaction(std::string from = "", std::string to = "", float amt = 0) :
-		fromAddress{ from }, toAddress{ to }, amount{ amt } {}
+	// PostCondition: transaction of amt currency units, rounded to the nearest cent
+	Transaction(std::string from = "", std::string to = "", double amt = 0) :
+		fromAddress{ std::move(from) }, toAddress{ std::move(to) }, amount{ amountToCents(amt) } {}
+
+	// PostCondition: returns transaction of a whole number of cents
+	static Transaction fromCents(std::string from, std::string to, std::int64_t cents) {
+		Transaction t(std::move(from), std::move(to));
+		t.amount = cents;
+		return t;
+	}
 
 	// return a transaction as a string
 	std::string toString() const {
-		std::stringstream ss;
-		ss << "(" << fromAddress << "->" << toAddress << " : " << std::fixed
-			<< std::setprecision(2) << amount << ")";
-		return ss.str();
+		return "(" + fromAddress + "->" + toAddress + " : " + formatCents(amount) + ")";
+	}
+
+	// PostCondition: returns true if both transactions transfer the same amount between the same addresses
+	bool operator==(const Transaction & other) const {
+		return fromAddress == other.fromAddress && toAddress == other.toAddress && amount == other.amount;
+	}
+	bool operator!=(const Transaction & other) const {
+		return !operator==(other);
+	}
+
+	// PostCondition: canonical binary form (from, to, amount in cents) appended to out
+	void encode(std::string & out) const {
+		encodeString(out, fromAddress);
+		encodeString(out, toAddress);
+		encodeI64(out, amount);
 	}
 
 	// public member properties
 	std::string fromAddress; // record of person sending funds
 	std::string toAddress;	 // record of person receiving funds
-	float amount;			 // amount transfered
+	std::int64_t amount;	 // amount transfered in cents
 };
 
 
+// ------------------------ Hash input of a block ---------------------------------//
+// Templates so a Block and a stored BlockView produce the same hash input
+
+// PostCondition: buffer replaced by the part of the hash input of b that does not
+//                depend on the nonce, buffer capacity is reused
+template <class B>
+void encodeBlockPrefix(const B & b, std::string & buffer) {
+	buffer.clear();
+	if (b.version >= 2) {
+		buffer.push_back(static_cast<char>(b.version));
+		encodeString(buffer, b.previousHash);
+		encodeString(buffer, b.timestamp);
+		encodeU32(buffer, static_cast<std::uint32_t>(b.transactions.size()));
+		for (const auto & t : b.transactions) {
+			t.encode(buffer);
+		}
+	}
+	else {
+		// convert transactions to stringstream representation
+		// then to extract a string from the stream call ss.str()
+		std::stringstream ss;
+		ss << b.transactions << b.previousHash << b.timestamp;
+
+		// create string from transaction stream, previous hash and timestamp
+		buffer = ss.str();
+	}
+}
+
+// PostCondition: buffer replaced by the complete hash input of b for its nonce
+template <class B>
+void encodeBlockPreimage(const B & b, std::string & buffer) {
+	encodeBlockPrefix(b, buffer);
+	buffer += encodeNonce(b.nonce, (b.version >= 2) ? NonceEncoding::Binary32 : NonceEncoding::Decimal);
+}
+
+
 // ----------------------------- A Block -----------------------------------------//
 // Contains fixed number of transactions (2 in this example) along with a creation 
 // timestamp, a hash of the block and a copy of the hash of the previous block
 // (ideally would be declared as a private member of the BlockChain class)        
+//
+// Version 1 blocks hash the printed transactions, previous hash, timestamp and the
+// nonce in decimal. Version 2 blocks hash a length prefixed binary encoding
+// (version, previous hash, timestamp, transaction count, transactions with amounts
+// in cents) followed by the nonce as 4 little endian bytes.
 // -------------------------------------------------------------------------------//
 struct Block {
-	Block() : transactions{}, timestamp{ "" }, previousHash{ "" }, hash{ "" } {
+	Block() : transactions{}, timestamp{ "" }, previousHash{ "" }, hash{ "" }, nonce{ 0 }, version{ 1 } {
 		// set timestamp of block creation as current time		
 		timestamp = std::to_string(std::time(0));
 		hash = calculateHash();
 	};
 
-	Block(const ArrayList<Transaction> & trans, std::string prevHash) :
-		transactions{ trans }, timestamp{ "" }, previousHash{ prevHash }, hash{ "" } {
+	Block(ArrayList<Transaction> trans, std::string prevHash, int version = 1) :
+		transactions{ std::move(trans) }, timestamp{ "" }, previousHash{ std::move(prevHash) }, hash{ "" }, nonce{ 0 },
+		version{ version } {
 
 		// set timestamp of block creation as current time		
 		timestamp = std::to_string(std::time(0));
 		hash = calculateHash();
 	};
 
+	// PostCondition: block restored from stored fields, the hash is not recalculated
+	Block(ArrayList<Transaction> trans, std::string prevHash, std::string time, int nonce, std::string hash, int version) :
+		hash{ std::move(hash) }, previousHash{ std::move(prevHash) }, timestamp{ std::move(time) },
+		transactions{ std::move(trans) }, nonce{ nonce }, version{ version } {}
+
 	std::string hash;						// hash of this block
 	std::string previousHash;				// hash of previous block
 	std::string timestamp;					// time of block creation
 	ArrayList< Transaction > transactions;	// transactions stored in block
 
 	int nonce;		// used to generate new hash as part of proof of work
+	int version;	// format of the hash input (1 text, 2 binary)
 
-					// PostCondition: return hex string hash of block
-	std::string calculateHash() const {
-		// convert transactions to stringstream representation
-		// then to extract a string from the stream call ss.str()
-		std::stringstream ss;
-		ss << transactions;
+	// PostCondition: return the part of the hash input that does not depend on the nonce
+	std::string hashPrefix() const {
+		std::string prefix;
+		encodePrefix(prefix);
+		return prefix;
+	}
+
+	// PostCondition: buffer replaced by the part of the hash input that does not depend
+	//                on the nonce, buffer capacity is reused
+	void encodePrefix(std::string & buffer) const {
+		encodeBlockPrefix(*this, buffer);
+	}
 
-		// create string from transaction stream, previous hash, timestamp and nonce
-		std::string blockStr = ss.str() + previousHash + timestamp + std::to_string(nonce);
+	// PostCondition: buffer replaced by the complete hash input for the current nonce
+	void encodePreimage(std::string & buffer) const {
+		encodeBlockPreimage(*this, buffer);
+	}
+
+	// PostCondition: returns how the nonce is appended to the hash input
+	NonceEncoding nonceEncoding() const {
+		return (version >= 2) ? NonceEncoding::Binary32 : NonceEncoding::Decimal;
+	}
 
-		// return hex string hash of the string representation of the block
-		return picosha2::hash256_hex_string(blockStr);
+	// PostCondition: return hex string hash of block
+	std::string calculateHash() const {
+		// return hex string hash of the encoded block and nonce
+		std::string preimage;
+		encodePreimage(preimage);
+		return picosha2::hash256_hex_string(preimage);
 	}
 
-	// PostCondition: proof of work carried out to mine a new block
+	// PostCondition: proof of work carried out to mine a new block using numThreads
+	// worker threads, the nonce found is the same a single thread would find
 	// setting difficulty level above 4 will cause mining to take a long time
 	// in real world it takes at least 10 mins to mine a single block
-	void mineBlock(int difficulty) {
+	MiningResult mineBlock(int difficulty, int numThreads = 1) {
+		return mineBlock(DifficultyTarget::fromHexDigits(difficulty), numThreads);
+	}
+
+	// PostCondition: proof of work carried out until hash begins with target.bits() 0 bits
+	MiningResult mineBlock(const DifficultyTarget & target, int numThreads = 1) {
 		std::cout << "Mining block.. ";
 
-		// while the hash does not begin with difficulty 0's
-		while (hash.substr(0, difficulty) != std::string().append(difficulty, '0')) {
-			nonce++;				// increment nonce to cause hash change  
-			hash = calculateHash(); // generate the new hash
-		}
+		// search for lowest nonce producing a hash meeting the target
+		MiningResult result = ParallelMiner(numThreads).mine(hashPrefix(), target, nonce, nonceEncoding());
+		nonce = result.nonce;
+		hash = result.hash;
+
 		std::cout << hash << "\n";
+		if (result.threads.size() > 1) {
+			for (size_t t = 0; t < result.threads.size(); t++) {
+				std::cout << "  thread " << t << ": " << static_cast<long long>(result.threads[t].hashRate()) << " H/s\n";
+			}
+		}
+		return result;
 	}
 
 	// PostCondition: return string representation of a Block
@@ -108,73 +235,182 @@ struct Block {
 // ------------------------  The BlockChain Class ----------------------------
 class BlockChain {
 public:
-	BlockChain(int difficulty = 1, float reward = 0.05) : chain{}, pendingTransactions{},
-		difficulty{ difficulty }, miningReward{ reward } {
+	BlockChain(int difficulty = 1, double reward = 0.05) : chain{}, pendingTransactions{},
+		target{ DifficultyTarget::fromHexDigits(difficulty) }, miningReward{ amountToCents(reward) }, minerThreads{ 1 }, validatedBlocks{ 1 },
+		useInbox{ false }, ledger{ new Ledger() }, concurrentReaders{ false }, blockVersion{ 1 } {
 		// create initial chain genesis block
 		createGenesisBlock();
 	}
 
+	~BlockChain() {
+		delete ledger.load();
+	}
+
+	BlockChain(const BlockChain &) = delete;
+	BlockChain & operator=(const BlockChain &) = delete;
+
+	// PreCondition:  no reader or mining thread is running
+	// PostCondition: when enabled each mined block publishes a new copy of the ledger
+	//                index so reader threads never see it part way through an update,
+	//                otherwise the index is updated in place
+	void setConcurrentReaders(bool enable) {
+		concurrentReaders = enable;
+	}
+
 	// PreCondition: dif >=1 && dif <=MAXDIFFICULTY
 	// PostCondition: new difficulty level set for proof of work when mining a block
 	void setDifficulty(int dif) {
 		if (dif >= 1 && dif <= MAXDIFFICULTY) {
-			difficulty = dif;
+			target = DifficultyTarget::fromHexDigits(dif);
 		}
 	}
 
+	// PreCondition: bits >=1 && bits <= 4 * MAXDIFFICULTY
+	// PostCondition: proof of work requires hash to begin with bits 0 bits, allows
+	//                difficulty to be tuned between the hex digit levels
+	void setDifficultyBits(int bits) {
+		if (bits >= 1 && bits <= 4 * MAXDIFFICULTY) {
+			target = DifficultyTarget(bits);
+		}
+	}
+
+	// PostCondition: number of threads used for proof of work set (0 uses all hardware threads)
+	void setMinerThreads(int n) {
+		minerThreads = (n >= 0) ? n : 1;
+	}
+
+	// PreCondition:  called on the mining thread, the result is overwritten by each
+	//                minerGenerateBlock so it is not safe for concurrent readers
+	// PostCondition: returns statistics of the most recent proof of work
+	const MiningResult & getLastMiningResult() const {
+		return lastMining;
+	}
+
 	// PostCondition: new mining reward set for future mined blocks
-	void setReward(float reward) {
-		miningReward = reward;
+	void setReward(double reward) {
+		miningReward = amountToCents(reward);
 	}
 
-	// PostCondition: return true if chain is valid, otherwise false
-	bool isChainValid() const {
-		// verify that all block (excluding genesis) are valid
-		for (int i = 1; i < chain.size(); i++) {
-			Block currentBlock = chain.get(i);
-			Block previousBlock = chain.get(i - 1);
-			if (currentBlock.hash != currentBlock.calculateHash()) {
-				return false;
+	// PreCondition:  no other thread is using the BlockChain
+	// PostCondition: chain persisted in directory, blocks are written groupCommit at a
+	//                time with one fsync. If the directory already holds blocks the chain
+	//                is replaced by them and they are trusted without being rehashed,
+	//                otherwise the current chain is written to it
+	void openStore(const std::string & directory, int groupCommit = 64) {
+		store.reset(new BlockStore<Block>());
+		store->setGroupCommit(groupCommit);
+		store->open(directory);
+		if (store->size() == 0) {
+			for (SegmentedIterator<Block> itr = chain.begin(); itr != chain.end(); itr++) {
+				store->append(*itr);
 			}
-			if (currentBlock.previousHash != previousBlock.hash) {
-				return false;
+			store->flush();
+		}
+		else {
+			// resume from stored tip and rebuild the ledger index
+			Ledger * restored = new Ledger();
+			chain.clear();
+			for (int i = 0; i < store->size(); i++) {
+				chain.add(store->get(i));
+				restored->apply(chain.back());
 			}
+			restored->blocks = chain.size();
+			delete ledger.exchange(restored);
+			validatedBlocks.store(chain.size());
 		}
-		return true;
 	}
 
-	// PostCondition: add a new pending transaction
+	// PostCondition: blocks waiting for the next group commit written to disk, throws
+	//                std::runtime_error if they cannot be (the destructor cannot report it)
+	void flushStore() {
+		if (store) {
+			store->flush();
+		}
+	}
+
+	// PreCondition: version == 1 || version == 2
+	// PostCondition: future mined blocks hash their text (1) or binary (2) encoding,
+	//                blocks already in the chain keep their version
+	void setBlockVersion(int version) {
+		if (version == 1 || version == 2) {
+			blockVersion = version;
+		}
+	}
+
+	// PostCondition: return true if chain is valid, otherwise false
+	// blocks are rehashed in parallel and only blocks appended since the last
+	// successful validation are checked
+	bool isChainValid() const {
+		// verify blocks appended since the watermark
+		int size = chain.size();
+		int from = validatedBlocks.load();
+		if (size - from <= 0) {
+			return true;
+		}
+		int valid = validateBlocks(chain, from, size);
+
+		// advance watermark over the valid blocks (other readers may also advance it)
+		int current = validatedBlocks.load();
+		while (valid > current && !validatedBlocks.compare_exchange_weak(current, valid)) {}
+		return valid == size;
+	}
+
+	// PostCondition: when enabled transactions are submitted through a lock-free inbox,
+	//                so any number of threads may call addTransaction while a miner runs
+	void setConcurrentInbox(bool enable) {
+		if (!enable) {
+			drainInbox();
+		}
+		useInbox = enable;
+	}
+
+	// PostCondition: add a new pending transaction (thread safe when the inbox is enabled)
 	void addTransaction(const Transaction & t) {
-		pendingTransactions.add(t);
+		if (useInbox) {
+			inbox.enqueue(t);
+		}
+		else {
+			pendingTransactions.add(t);
+		}
+	}
+
+	// PostCondition: pending transactions are mined largest amount first when
+	//                enabled, otherwise in the order they were added
+	void prioritiseByAmount(bool enable) {
+		pendingTransactions.setPriority(enable ? transactionAmount : nullptr);
 	}
 
 	// PostCondition: a miner creates a new block (carrying out proof of work) and adds to the chain
 	bool minerGenerateBlock(std::string minerAccount) {
 		bool blockMined = false; // was a block mined successfully 
 
+		// collect transactions submitted since the last block
+		drainInbox();
+
 								 // ensure enough pending transactions available to create a Block
 		if (pendingTransactions.size() >= BLOCKSIZE) {
 			// create fixed size transaction list for addition to block
 			ArrayList<Transaction> trans(BLOCKSIZE);
 
-			// add pending transactions to Fixed size block transaction List
-			for (int i = 1; i <= BLOCKSIZE; i++) {
-				trans.add(pendingTransactions.get(0));
-				pendingTransactions.remove(0);
-			}
+			// move next pending transactions to Fixed size block transaction List
+			pendingTransactions.takeBatch(BLOCKSIZE, trans);
 
 			// create a new block with mined transactions and hash of last block
-			Block block(trans, getLatestBlock().hash);
+			Block block(std::move(trans), getLatestBlock().hash, blockVersion);
 
 			// carry out the proof of work
-			block.mineBlock(difficulty);
+			lastMining = block.mineBlock(target, minerThreads);
 
-			// add mined block to the chain
-			chain.add(block);
+			// move mined block to the chain and add its transactions to the ledger
+			chain.add(std::move(block));
+			if (store) {
+				store->append(chain.back());
+			}
+			updateLedger(chain.back());
 
 			// send miner their playment from the bank
 
-			pendingTransactions.add(Transaction("bank", minerAccount, miningReward));
+			pendingTransactions.add(Transaction::fromCents("bank", minerAccount, miningReward));
 
 			// block successfully mined
 			blockMined = true;
@@ -182,39 +418,74 @@ public:
 		return blockMined;
 	}
 
-	// PostCondition: searches chain for transactions containing address and 
-	//				  calculates and returns the balance of the address
-	float getBalanceOfAddress(std::string address) const {
-		float balance = 0;
-
-		// COMPLETE THIS FUNCTION
-		// loop through each block 
-		// loop though each transaction within a block
-		// if the fromAddress of transaction is equal to address then reduce balance by transaction amount
-		// if the toAddress of transaction is equal to address then increase balance by transaction amount
-
+	// PostCondition: returns the balance of address in cents from the ledger index, i.e.
+	//                the sum received less the sum sent in all transactions in the chain
+	std::int64_t getBalanceOfAddress(std::string address) const {
+		const Ledger * l = acquireLedger();
+		std::int64_t balance = l->balanceOf(address);
+		releaseLedger();
 		return balance;
 	}
 
-	std::string toString() const {
-		std::stringstream ss;
-		if (isChainValid()) {
-			ss << "--------------------Block Chain-----------------\n";
+	// PostCondition: returns a snapshot of the balance in cents of every address in the chain
+	std::unordered_map<std::string, std::int64_t> getBalances() const {
+		const Ledger * l = acquireLedger();
+		std::unordered_map<std::string, std::int64_t> snapshot = l->all();
+		releaseLedger();
+		return snapshot;
+	}
+
+	// PostCondition: returns true if rebuilding the ledger index from the chain
+	//                reproduces the incrementally maintained index
+	bool verifyBalances() const {
+		const Ledger * l = acquireLedger();
+		std::unordered_map<std::string, std::int64_t> rebuilt;
+		for (SegmentedIterator<Block> itr = chain.begin(), end = chain.begin() + l->blocks; itr != end; itr++) {
+			applyToLedger(*itr, rebuilt);
 		}
-		else {
-			ss << "------------***INVALID*** Block Chain-----------\n";
+		bool same = (rebuilt == l->all());
+		releaseLedger();
+		return same;
+	}
+
+	// PostCondition: chain written to os block by block through a chunked buffer, as
+	//                text (the toString format) or as JSON lines, one object per block
+	//                including the genesis block
+	void writeTo(std::ostream & os, ChainFormat format = ChainFormat::Text) const {
+		ChainWriter writer(os, format);
+		bool text = (format == ChainFormat::Text);
+		if (text) {
+			if (isChainValid()) {
+				writer.write("--------------------Block Chain-----------------\n");
+			}
+			else {
+				writer.write("------------***INVALID*** Block Chain-----------\n");
+			}
 		}
 
-		// exclude the genesis block so start at 1
-		for (int i = 1; i < chain.size(); i++) {
-			Block b = chain.get(i);
-			ss << "Block " << i << ": " << b.toString() << "\n";
+		// text excludes the genesis block so start at 1, stop at the blocks published when starting
+		for (SegmentedIterator<Block> itr = chain.begin() + (text ? 1 : 0), end = chain.end(); itr != end; itr++) {
+			writer.writeBlock(itr.index(), *itr);
 		}
 
-		// output pending transactions
-		ss << "\nPending: " << pendingTransactions << "\n";
+		if (text) {
+			// output pending transactions (owned by the miner when readers run concurrently)
+			if (!concurrentReaders) {
+				writer.write("\nPending: ");
+				writer.flush();
+				os << pendingTransactions;
+				writer.write("\n");
+			}
+			if (useInbox) {
+				writer.write("Inbox: " + std::to_string(inbox.size()) + " submitted\n");
+			}
+			writer.write("------------------- End ------------------\n");
+		}
+	}
 
-		ss << "------------------- End ------------------\n";
+	std::string toString() const {
+		std::stringstream ss;
+		writeTo(ss);
 		return ss.str();
 	}
 
@@ -222,11 +493,206 @@ private:
 	const static int BLOCKSIZE = 2; // each block will only contain a fixed number of transactions
 	const static int MAXDIFFICULTY = 5; // maximum difficulty level  
 
-	LinkedList< Block > chain;
-	ArrayList<Transaction> pendingTransactions;
-	int difficulty;
-	float miningReward;
-	float bankBalance;
+	SegmentedList< Block > chain;
+	Mempool<Transaction> pendingTransactions;
+	DifficultyTarget target;	// proof of work target
+	std::int64_t miningReward;	// cents paid to the miner of each block
+	int minerThreads;			// worker threads used for proof of work
+	MiningResult lastMining;	// statistics of most recent proof of work
+	mutable std::atomic<int> validatedBlocks;	// leading blocks known to be valid (watermark)
+	ConcurrentQueue<Transaction> inbox;	// transactions submitted by producer threads
+	bool useInbox;						// addTransaction submits to inbox
+
+	// ledger index of address balances (in cents) after the first blocks blocks. The
+	// balances are split into shards by address, a ledger copied to publish the next
+	// block shares every shard with the original until it changes one
+	struct Ledger {
+		typedef std::unordered_map<std::string, std::int64_t> Balances;
+		const static int SHARDS = 256;
+
+		Ledger() {
+			for (std::shared_ptr<Balances> & s : shards) {
+				s = std::make_shared<Balances>();
+			}
+		}
+
+		static int shardOf(const std::string & address) {
+			return static_cast<int>(std::hash<std::string>()(address) % SHARDS);
+		}
+
+		// PostCondition: returns balance of address in cents
+		std::int64_t balanceOf(const std::string & address) const {
+			const Balances & s = *shards[shardOf(address)];
+			auto itr = s.find(address);
+			return (itr != s.end()) ? itr->second : 0;
+		}
+
+		// PostCondition: returns the balance of every address
+		Balances all() const {
+			Balances balances;
+			for (const std::shared_ptr<Balances> & s : shards) {
+				balances.insert(s->begin(), s->end());
+			}
+			return balances;
+		}
+
+		// PostCondition: transactions of block b applied, a shard still shared with
+		//                previous (the ledger this one was copied from) is copied first
+		void apply(const Block & b, const Ledger * previous = nullptr) {
+			for (const Transaction & t : b.transactions) {
+				shard(t.fromAddress, previous)[t.fromAddress] -= t.amount;
+				shard(t.toAddress, previous)[t.toAddress] += t.amount;
+			}
+		}
+
+		int blocks = 0;
+		std::shared_ptr<Balances> shards[SHARDS];	// balances, shared between ledgers until changed
+
+	private:
+		Balances & shard(const std::string & address, const Ledger * previous) {
+			int i = shardOf(address);
+			if (previous != nullptr && shards[i] == previous->shards[i]) {
+				shards[i] = std::make_shared<Balances>(*shards[i]);
+			}
+			return *shards[i];
+		}
+	};
+	const static int LEDGERSLOT = 2;	// hazard pointer slot of readers (0 and 1 used by ConcurrentQueue)
+	std::atomic<Ledger *> ledger;	// current ledger, read under a hazard pointer when concurrent
+	bool concurrentReaders;			// publish a new ledger for each block
+	int blockVersion;				// format of newly mined blocks
+	std::unique_ptr<BlockStore<Block>> store;	// persistent copy of the chain (optional)
+
+	// PostCondition: transactions of block b (the last block) added to the ledger index
+	void updateLedger(const Block & b) {
+		Ledger * current = ledger.load();
+		if (concurrentReaders) {
+			// copy (sharing the shards), update the shards b changes then publish
+			Ledger * next = new Ledger(*current);
+			next->apply(b, current);
+			next->blocks = chain.size();
+			ledger.store(next, std::memory_order_release);
+
+			// old ledger freed as soon as no reader holds it rather than once hundreds
+			// have been retired
+			HazardPointers::retire(current);
+			HazardPointers::reclaim();
+		}
+		else {
+			current->apply(b);
+			current->blocks = chain.size();
+		}
+	}
+
+	// PostCondition: returns the current ledger, published in the LEDGERSLOT hazard
+	//                pointer when readers run concurrently (until releaseLedger)
+	const Ledger * acquireLedger() const {
+		return concurrentReaders ? HazardPointers::protect(LEDGERSLOT, ledger) : ledger.load(std::memory_order_acquire);
+	}
+
+	void releaseLedger() const {
+		if (concurrentReaders) {
+			HazardPointers::clear(LEDGERSLOT);
+		}
+	}
+
+	// PostCondition: transactions waiting in the inbox moved to the pending transactions
+	void drainInbox() {
+		Transaction t;
+		while (inbox.tryDequeue(t)) {
+			pendingTransactions.add(std::move(t));
+		}
+	}
+
+	const static int MINVALIDATIONCHUNK = 256; // minimum blocks validated per thread
+
+	friend class ChainView;	// validates stored blocks the same way
+
+	// PreCondition:  from >= 1, blocks.at(i) returns a Block or BlockView
+	// PostCondition: returns index of first invalid block in [from,to) or to if all
+	//                are valid, blocks are rehashed in parallel chunks
+	template <class Blocks>
+	static int validateBlocks(const Blocks & blocks, int from, int to) {
+		int count = to - from;
+		int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+		numThreads = std::max(1, std::min(numThreads, count / MINVALIDATIONCHUNK));
+		std::vector<int> firstInvalid(numThreads);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < numThreads; t++) {
+			int first = from + count * t / numThreads;
+			int last = from + count * (t + 1) / numThreads;
+			if (t == numThreads - 1) {
+				firstInvalid[t] = firstInvalidBlock(blocks, first, last);
+			}
+			else {
+				workers.emplace_back([&blocks, &firstInvalid, t, first, last]() {
+					firstInvalid[t] = firstInvalidBlock(blocks, first, last);
+				});
+			}
+		}
+		for (std::thread & w : workers) {
+			w.join();
+		}
+		return *std::min_element(firstInvalid.begin(), firstInvalid.end());
+	}
+
+	// PostCondition: returns index of first block in [from,to) whose hash or link to the
+	//                previous block is invalid, or to if all are valid
+	template <class Blocks>
+	static int firstInvalidBlock(const Blocks & blocks, int from, int to) {
+		std::string preimages[picosha2::k_multi_lanes];
+		const picosha2::byte_t * data[picosha2::k_multi_lanes];
+		std::size_t lengths[picosha2::k_multi_lanes];
+		picosha2::byte_t digests[picosha2::k_multi_lanes * picosha2::k_digest_size];
+
+		for (int i = from; i < to; i += picosha2::k_multi_lanes) {
+			// rehash a batch of blocks together
+			int batch = std::min(to - i, static_cast<int>(picosha2::k_multi_lanes));
+			for (int b = 0; b < batch; b++) {
+				encodeBlockPreimage(blocks.at(i + b), preimages[b]);	// reuses buffer of earlier batches
+				data[b] = reinterpret_cast<const picosha2::byte_t *>(preimages[b].data());
+				lengths[b] = preimages[b].size();
+			}
+			picosha2::hash256_multi(data, lengths, batch, digests);
+
+			for (int b = 0; b < batch; b++) {
+				const auto & current = blocks.at(i + b);
+				if (!hexEquals(current.hash, digests + b * picosha2::k_digest_size) ||
+					current.previousHash != blocks.at(i + b - 1).hash) {
+					return i + b;
+				}
+			}
+		}
+		return to;
+	}
+
+	// PostCondition: returns priority of a pending transaction
+	static double transactionAmount(const Transaction & t) {
+		return static_cast<double>(t.amount);
+	}
+
+	// PostCondition: transactions of block b applied to the balances in ledger (used to
+	//                check the ledger index)
+	static void applyToLedger(const Block & b, std::unordered_map<std::string, std::int64_t> & ledger) {
+		for (const Transaction & t : b.transactions) {
+			ledger[t.fromAddress] -= t.amount;
+			ledger[t.toAddress] += t.amount;
+		}
+	}
+
+	// PostCondition: returns true if hex is the lower case hex string of digest
+	static bool hexEquals(std::string_view hex, const picosha2::byte_t * digest) {
+		static const char digits[] = "0123456789abcdef";
+		if (hex.size() != 2 * picosha2::k_digest_size) {
+			return false;
+		}
+		for (std::size_t i = 0; i < picosha2::k_digest_size; i++) {
+			if (hex[2 * i] != digits[digest[i] >> 4] || hex[2 * i + 1] != digits[digest[i] & 15]) {
+				return false;
+			}
+		}
+		return true;
+	}
 
 	// private member function to create genesis block - called in constructor
 	void createGenesisBlock() {
@@ -236,14 +702,94 @@ private:
 		genesisBlock.hash = genesisBlock.calculateHash();
 
 		// add block to the chain
-		chain.add(genesisBlock);
+		chain.add(std::move(genesisBlock));
+		updateLedger(chain.back());
+	}
+
+	// PostCondition: reference to last block in chain returned
+	const Block & getLatestBlock() const {
+		return chain.back();
+	}
+
+};
+
+
+// ------------------ Read only view of a stored chain ----------------------------
+// Blocks are read in place from the memory mapped segments written by
+// BlockChain::openStore, so inspecting a chain of any size allocates nothing
+// per block. The directory is never modified.
+class ChainView {
+public:
+	// PostCondition: durable blocks stored in directory are mapped for reading
+	explicit ChainView(const std::string & directory) {
+		store.open(directory, true);
+	}
+
+	// PostCondition: returns number of stored blocks, including the genesis block
+	int size() const {
+		return store.durableSize();
+	}
+
+	// PreCondition:  pos >= 0 && pos < size()
+	// PostCondition: returns view of block at pos, valid while the ChainView exists
+	BlockView at(int pos) const {
+		return store.view(pos);
 	}
 
-	// PostCondition: last block in chain returned
-	Block getLatestBlock() const {
-		return chain.get(chain.size() - 1);
+	// PostCondition: return true if every stored block hashes correctly and links to
+	//                the block before it
+	bool isChainValid() const {
+		return size() <= 1 || BlockChain::validateBlocks(*this, 1, size()) == size();
+	}
+
+	// PostCondition: returns the sum in cents received less the sum sent by address in
+	//                all stored transactions
+	std::int64_t getBalanceOfAddress(std::string_view address) const {
+		std::int64_t balance = 0;
+		for (int i = 0; i < size(); i++) {
+			for (const TransactionView & t : at(i).transactions) {
+				if (t.fromAddress == address) {
+					balance -= t.amount;
+				}
+				if (t.toAddress == address) {
+					balance += t.amount;
+				}
+			}
+		}
+		return balance;
 	}
 
+	// PostCondition: stored chain written to os block by block, as text or as JSON
+	//                lines (one object per block including the genesis block)
+	void writeTo(std::ostream & os, ChainFormat format = ChainFormat::Text) const {
+		ChainWriter writer(os, format);
+		bool text = (format == ChainFormat::Text);
+		if (text) {
+			if (isChainValid()) {
+				writer.write("--------------------Block Chain-----------------\n");
+			}
+			else {
+				writer.write("------------***INVALID*** Block Chain-----------\n");
+			}
+		}
+
+		// text excludes the genesis block so start at 1
+		for (int i = text ? 1 : 0; i < size(); i++) {
+			writer.writeBlock(i, at(i));
+		}
+		if (text) {
+			writer.write("------------------- End ------------------\n");
+		}
+	}
+
+	std::string toString() const {
+		std::stringstream ss;
+		writeTo(ss);
+		return ss.str();
+	}
+
+private:
+	BlockStore<Block> store;	// opened read only
 };
 
 
@@ -254,7 +800,7 @@ std::ostream& operator <<(std::ostream& output, const Block & b) {
 }
 
 std::ostream& operator <<(std::ostream& output, const BlockChain & c) {
-	output << c.toString();
+	c.writeTo(output);
 	return output;  // for multiple << operators.
 }
 
@@ -262,3 +808,8 @@ std::ostream& operator <<(std::ostream& output, const Transaction & t) {
 	output << t.toString();
 	return output;  // for multiple << operators.
 }
+
+std::ostream& operator <<(std::ostream& output, const ChainView & c) {
+	c.writeTo(output);
+	return output;  // for multiple << operators.
+}
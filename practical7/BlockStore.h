@@ -0,0 +1,327 @@
+/**
+ * BlockStore.h
+ *
+ * Append only persistent store of the blocks of a BlockChain.
+ *
+ * Blocks are written as records to a sequence of segment files
+ * (blocks-000000.seg, blocks-000001.seg, ...) in a directory. Each record is
+ *
+ *     u32 magic | u32 payload length | u32 CRC-32 of payload | payload
+ *
+ * where the payload holds every field of the block, amounts stored as whole
+ * cents so version 1 hashes can be reproduced exactly. Appends are
+ * buffered and written with a single fsync per group of blocks (group commit).
+ *
+ * On open the segments are memory mapped and scanned to build the offset
+ * index, a torn record at the end of the last segment (from a crash part way
+ * through a write) is cut off. Stored blocks can be read in place as
+ * BlockViews without decoding them into Blocks.
+ *
+ * A store opened read only never modifies the directory and a torn record
+ * is simply ignored.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.1
+ */
+
+#ifndef BLOCKSTORE_H
+#define BLOCKSTORE_H
+
+#include "Encoding.h"
+#include "BlockView.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstdio>		// std::snprintf
+#include <stdexcept>
+#include <string>
+#include <type_traits>	// std::decay
+#include <vector>
+
+// ------------------------- The BlockStore Class ------------------------------
+// Block is any type providing the fields of the BlockChain Block, the store
+// is a template so it does not depend on BlockChain.h
+template <class Block>
+class BlockStore {
+public:
+	const static std::uint32_t MAGIC = 0x314b4c42;			// "BLK1"
+	const static std::size_t HEADERSIZE = 12;				// magic, length, checksum
+	const static std::size_t MAXSEGMENTBYTES = 64u << 20;	// new segment started beyond 64MB
+
+	BlockStore() : groupSize(64), pendingBlocks(0), readOnly(false) {}
+
+	// PostCondition: pending blocks written if possible, a failure cannot be reported
+	//                from a destructor so call flush first to be told of it
+	~BlockStore() {
+		if (file.isOpen()) {
+			try {
+				flush();
+			}
+			catch (const std::exception &) {
+				// blocks not yet flushed are lost, as if the process had stopped
+			}
+		}
+	}
+	BlockStore(const BlockStore &) = delete;
+	BlockStore & operator=(const BlockStore &) = delete;
+
+	void open(const std::string & directory, bool readOnly = false);
+	void append(const Block & b);
+	void flush();
+	void setGroupCommit(int blocks);
+
+	int size() const				{ return static_cast<int>(index.size()); }
+	int durableSize() const			{ return size() - pendingBlocks; }
+	int segmentCount() const		{ return static_cast<int>(segments.size()); }
+	Block get(int pos);
+	BlockView view(int pos) const;
+
+	static std::uint32_t crc32(const char * data, std::size_t n);
+
+private:
+	struct Location {
+		int segment;			// segment file holding the record
+		std::size_t offset;		// offset of record header in segment
+		std::uint32_t length;	// payload length
+	};
+
+	std::string segmentPath(int segment) const;
+	void scan(int segment, bool last);
+	void startSegment(int segment);
+	static void encode(std::string & out, const Block & b);
+	static Block decode(const BlockView & v);
+
+	std::string directory;
+	std::vector<Location> index;		// location of every block, in chain order
+	std::vector<MappedFile> segments;	// read only mapping of each segment
+	AppendFile file;					// last segment, open for appending
+	int current;						// number of the last segment
+	std::string pending;				// records not yet written to file
+	int groupSize;						// blocks written per fsync
+	int pendingBlocks;					// blocks in pending
+	bool readOnly;						// store opened for reading only
+};
+
+// --------------- BlockStore Implementation -----------------------
+
+// PostCondition: returns CRC-32 (IEEE) of n bytes of data
+template <class Block>
+std::uint32_t BlockStore<Block>::crc32(const char * data, std::size_t n) {
+	static const std::vector<std::uint32_t> table = [] {
+		std::vector<std::uint32_t> t(256);
+		for (std::uint32_t i = 0; i < 256; i++) {
+			std::uint32_t c = i;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			}
+			t[i] = c;
+		}
+		return t;
+	}();
+	std::uint32_t c = 0xffffffffu;
+	for (std::size_t i = 0; i < n; i++) {
+		c = table[(c ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (c >> 8);
+	}
+	return c ^ 0xffffffffu;
+}
+
+// PostCondition: returns path of segment file
+template <class Block>
+std::string BlockStore<Block>::segmentPath(int segment) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "blocks-%06d.seg", segment);
+	return directory + "/" + name;
+}
+
+// PostCondition: segments in directory mapped and indexed. Unless readOnly the
+//                directory is created if required and appends go to the last segment
+template <class Block>
+void BlockStore<Block>::open(const std::string & dir, bool readOnly) {
+	if (file.isOpen()) {
+		flush();
+		file.close();
+	}
+	directory = dir;
+	index.clear();
+	segments.clear();
+	this->readOnly = readOnly;
+	if (!readOnly) {
+		AppendFile::makeDirectory(directory);
+	}
+
+	int count = 0;
+	while (AppendFile::exists(segmentPath(count))) {
+		count++;
+	}
+	for (int s = 0; s < count; s++) {
+		scan(s, s == count - 1);
+	}
+	if (!readOnly) {
+		startSegment(count > 0 ? count - 1 : 0);
+	}
+}
+
+// PostCondition: records of segment mapped and added to index, a torn record at
+//                the end of the last segment is removed
+template <class Block>
+void BlockStore<Block>::scan(int segment, bool last) {
+	std::string path = segmentPath(segment);
+	segments.emplace_back(path);
+	const MappedFile & map = segments.back();
+
+	std::size_t offset = 0;
+	while (offset < map.size()) {
+		std::size_t left = map.size() - offset;
+		bool valid = left >= HEADERSIZE;
+		BinaryReader header(map.data() + offset, valid ? HEADERSIZE : 0);
+		std::uint32_t magic = valid ? header.u32() : 0;
+		std::uint32_t length = valid ? header.u32() : 0;
+		std::uint32_t checksum = valid ? header.u32() : 0;
+		valid = valid && magic == MAGIC && length <= left - HEADERSIZE &&
+			crc32(map.data() + offset + HEADERSIZE, length) == checksum;
+		if (!valid) {
+			if (!last) {
+				throw std::runtime_error("BlockStore: corrupt segment " + path);
+			}
+			// incomplete final write, discard it
+			if (readOnly) {
+				break;
+			}
+			segments.back().close();
+			AppendFile::truncate(path, offset);
+			segments.back().open(path);
+			break;
+		}
+		index.push_back(Location{ segment, offset, length });
+		offset += HEADERSIZE + length;
+	}
+}
+
+// PostCondition: segment opened for appending (and mapped if new), a newly
+//                created segment's directory entry is synced to disk
+template <class Block>
+void BlockStore<Block>::startSegment(int segment) {
+	std::string path = segmentPath(segment);
+	bool created = !AppendFile::exists(path);
+	current = segment;
+	file.open(path);
+	if (created) {
+		AppendFile::syncDirectory(directory);
+	}
+	if (static_cast<int>(segments.size()) <= segment) {
+		segments.emplace_back();
+	}
+}
+
+// PostCondition: number of blocks written per fsync set (1 syncs every block)
+template <class Block>
+void BlockStore<Block>::setGroupCommit(int blocks) {
+	groupSize = (blocks > 0) ? blocks : 1;
+	if (pendingBlocks >= groupSize) {
+		flush();
+	}
+}
+
+// PostCondition: b appended to the store, written to disk with the rest of its group
+template <class Block>
+void BlockStore<Block>::append(const Block & b) {
+	if (readOnly) {
+		throw std::logic_error("BlockStore: store is read only");
+	}
+	std::size_t start = pending.size();
+	pending.append(HEADERSIZE, '\0');
+	encode(pending, b);
+	std::uint32_t length = static_cast<std::uint32_t>(pending.size() - start - HEADERSIZE);
+	std::uint32_t header[3] = { MAGIC, length, crc32(pending.data() + start + HEADERSIZE, length) };
+	for (int h = 0; h < 3; h++) {
+		for (int i = 0; i < 4; i++) {
+			pending[start + 4 * h + i] = static_cast<char>((header[h] >> (8 * i)) & 0xff);
+		}
+	}
+
+	// records never span segments, start a new segment when this one is full
+	if (file.size() + pending.size() > MAXSEGMENTBYTES && file.size() + start > 0) {
+		std::string record = pending.substr(start);
+		pending.resize(start);
+		flush();
+		startSegment(current + 1);
+		pending = std::move(record);
+		start = 0;
+	}
+
+	index.push_back(Location{ current, file.size() + start, length });
+	pendingBlocks++;
+	if (pendingBlocks >= groupSize) {
+		flush();
+	}
+}
+
+// PostCondition: pending records written and synced to disk, and mapped for reading
+template <class Block>
+void BlockStore<Block>::flush() {
+	if (pendingBlocks > 0) {
+		file.write(pending.data(), pending.size());
+		file.sync();
+		pending.clear();
+		pendingBlocks = 0;
+		segments[current].open(segmentPath(current));
+	}
+}
+
+// PreCondition: pos >= 0 && pos < size()
+// PostCondition: returns copy of block stored at pos
+template <class Block>
+Block BlockStore<Block>::get(int pos) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("BlockStore: invalid position: " + std::to_string(pos));
+	}
+	if (pos >= durableSize()) {
+		flush();
+	}
+	return decode(view(pos));
+}
+
+// PreCondition: pos >= 0 && pos < durableSize()
+// PostCondition: returns view of block stored at pos, read in place from the mapped
+//                segment. On a read only store it is valid until the store is closed,
+//                on a writable store the next flush (or append completing a group)
+//                remaps the current segment and invalidates views of its blocks
+template <class Block>
+BlockView BlockStore<Block>::view(int pos) const {
+	if (pos < 0 || pos >= durableSize()) {
+		throw std::out_of_range("BlockStore: invalid position: " + std::to_string(pos));
+	}
+	const Location & loc = index[pos];
+	return BlockView(segments[loc.segment].data() + loc.offset + HEADERSIZE, loc.length);
+}
+
+// PostCondition: all fields of block b appended to out
+template <class Block>
+void BlockStore<Block>::encode(std::string & out, const Block & b) {
+	out.push_back(static_cast<char>(b.version));
+	encodeString(out, b.hash);
+	encodeString(out, b.previousHash);
+	encodeString(out, b.timestamp);
+	encodeU32(out, static_cast<std::uint32_t>(b.nonce));
+	encodeU32(out, static_cast<std::uint32_t>(b.transactions.size()));
+	for (const auto & t : b.transactions) {
+		encodeString(out, t.fromAddress);
+		encodeString(out, t.toAddress);
+		encodeI64(out, t.amount);
+	}
+}
+
+// PostCondition: returns copy of viewed block
+template <class Block>
+Block BlockStore<Block>::decode(const BlockView & v) {
+	decltype(Block().transactions) transactions(v.transactions.size());
+	using Transaction = typename std::decay<decltype(transactions.get(0))>::type;
+	for (const TransactionView & t : v.transactions) {
+		transactions.add(Transaction::fromCents(std::string(t.fromAddress), std::string(t.toAddress), t.amount));
+	}
+	return Block(std::move(transactions), std::string(v.previousHash), std::string(v.timestamp), v.nonce,
+		std::string(v.hash), v.version);
+}
+
+#endif /* BLOCKSTORE_H */
@@ -0,0 +1,160 @@
+/**
+ * BlockView.h
+ *
+ * Read only views of blocks stored by a BlockStore. A BlockView reads the
+ * fields of a stored record in place (strings are std::string_view into the
+ * memory mapped segment) so scanning a stored chain allocates nothing per
+ * block or transaction. Views of a read only store are valid while it stays
+ * open, on a writable store they are invalidated by the next flush.
+ *
+ * The views provide the same public fields as Block and Transaction, so code
+ * written as a template over the block type works with either.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef BLOCKVIEW_H
+#define BLOCKVIEW_H
+
+#include "Encoding.h"
+
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// ------------------ A stored transaction, read in place ------------------------
+struct TransactionView {
+	std::string_view fromAddress;	// record of person sending funds
+	std::string_view toAddress;		// record of person receiving funds
+	std::int64_t amount = 0;		// amount transfered in cents
+
+	// PostCondition: canonical binary form (from, to, amount in cents) appended to out,
+	//                identical to Transaction::encode
+	void encode(std::string & out) const {
+		encodeString(out, fromAddress);
+		encodeString(out, toAddress);
+		encodeI64(out, amount);
+	}
+};
+
+// PostCondition: transaction written to output as Transaction::toString would
+inline std::ostream& operator <<(std::ostream& output, const TransactionView & t) {
+	char digits[24];
+	int len = formatCents(digits, sizeof(digits), t.amount);
+	output << "(" << t.fromAddress << "->" << t.toAddress << " : ";
+	output.write(digits, len) << ")";
+	return output;  // for multiple << operators.
+}
+
+// ------------------ Forward iterator decoding transactions in place ------------
+class TransactionViewIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = TransactionView;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const TransactionView *;
+	using reference = const TransactionView &;
+
+	TransactionViewIterator(const char * p = nullptr, const char * end = nullptr) : p(p), end(end), next(p) {
+		decode();
+	}
+
+	reference operator*() const	{ return current; }
+	pointer operator->() const	{ return &current; }
+
+	TransactionViewIterator & operator++() {
+		p = next;
+		decode();
+		return *this;
+	}
+	TransactionViewIterator operator++(int) {
+		TransactionViewIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	bool operator==(const TransactionViewIterator & other) const { return p == other.p; }
+	bool operator!=(const TransactionViewIterator & other) const { return p != other.p; }
+
+private:
+	// PostCondition: current holds the transaction at p, next is the one after it
+	void decode() {
+		if (p != end) {
+			BinaryReader r(p, static_cast<std::size_t>(end - p));
+			current.fromAddress = r.string();
+			current.toAddress = r.string();
+			current.amount = r.i64();
+			next = end - r.remaining();
+		}
+	}
+
+	const char * p;			// encoded transaction
+	const char * end;		// end of the encoded transactions
+	const char * next;		// encoded transaction following p
+	TransactionView current;
+};
+
+// ------------------ The transactions of a BlockView ----------------------------
+class TransactionsView {
+public:
+	TransactionsView(const char * first = nullptr, const char * last = nullptr, int count = 0) :
+		first(first), last(last), count(count) {}
+
+	TransactionViewIterator begin() const	{ return TransactionViewIterator(first, last); }
+	TransactionViewIterator end() const		{ return TransactionViewIterator(last, last); }
+	int size() const						{ return count; }
+	bool isEmpty() const					{ return count == 0; }
+
+private:
+	const char * first;		// first encoded transaction
+	const char * last;		// end of the encoded transactions
+	int count;				// number of transactions
+};
+
+// PostCondition: transactions written to output as ArrayList<Transaction> prints them
+inline std::ostream& operator <<(std::ostream& output, const TransactionsView & l) {
+	output << "[ ";
+	for (const TransactionView & t : l) {
+		output << t << " ";
+	}
+	output << "]";
+	return output;  // for multiple << operators.
+}
+
+// ------------------ A stored block, read in place ------------------------------
+struct BlockView {
+	BlockView() : nonce{ 0 }, version{ 1 } {}
+
+	// PreCondition:  payload holds length bytes encoded by BlockStore
+	// PostCondition: fields refer to the payload, which must outlive the view
+	BlockView(const char * payload, std::size_t length) {
+		BinaryReader r(payload, length);
+		version = r.u8();
+		hash = r.string();
+		previousHash = r.string();
+		timestamp = r.string();
+		nonce = static_cast<int>(r.u32());
+		int count = static_cast<int>(r.u32());
+		transactions = TransactionsView(payload + length - r.remaining(), payload + length, count);
+	}
+
+	std::string_view hash;				// hash of this block
+	std::string_view previousHash;		// hash of previous block
+	std::string_view timestamp;			// time of block creation
+	TransactionsView transactions;		// transactions stored in block
+
+	int nonce;		// used to generate new hash as part of proof of work
+	int version;	// format of the hash input (1 text, 2 binary)
+};
+
+// PostCondition: block written to output as Block::toString would
+inline std::ostream& operator <<(std::ostream& output, const BlockView & b) {
+	output << b.transactions;
+	return output;  // for multiple << operators.
+}
+
+#endif /* BLOCKVIEW_H */
@@ -0,0 +1,162 @@
+/**
+ * ChainWriter.h
+ *
+ * Streams the blocks of a chain to an ostream one at a time. Output is
+ * collected in a fixed size chunk and handed to the stream each time the
+ * chunk fills, so printing a chain of any length only ever holds one chunk
+ * in memory rather than the whole text.
+ *
+ * Blocks are written either as the text used by BlockChain::toString or as
+ * JSON lines (one JSON object per block) for processing by other tools.
+ * writeBlock is a template so both Blocks and stored BlockViews can be written.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef CHAINWRITER_H
+#define CHAINWRITER_H
+
+#include "Encoding.h"	// formatCents
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>		// std::snprintf
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// ------------------ Output formats of a chain ----------------------------------
+enum class ChainFormat {
+	Text,		// "Block n: [ (from->to : amount) ... ]" lines as toString
+	JsonLines	// {"index":n,"hash":...,"transactions":[...]} one block per line
+};
+
+// ------------------ Chunked writer of blocks -----------------------------------
+class ChainWriter {
+public:
+	const static std::size_t CHUNKSIZE = 64 * 1024;	// default bytes buffered before writing
+
+	explicit ChainWriter(std::ostream & os, ChainFormat format = ChainFormat::Text, std::size_t chunkSize = CHUNKSIZE) :
+		os(os), format(format), chunkSize(chunkSize > 0 ? chunkSize : 1) {
+		buffer.reserve(this->chunkSize);
+	}
+	~ChainWriter() { flush(); }
+	ChainWriter(const ChainWriter &) = delete;
+	ChainWriter & operator=(const ChainWriter &) = delete;
+
+	ChainFormat getFormat() const { return format; }
+
+	// PostCondition: text written as is
+	void write(std::string_view text) {
+		if (buffer.size() + text.size() > chunkSize) {
+			flush();
+			if (text.size() >= chunkSize) {
+				os.write(text.data(), static_cast<std::streamsize>(text.size()));
+				return;
+			}
+		}
+		buffer.append(text.data(), text.size());
+	}
+
+	// PostCondition: block b at position index in the chain written in the writer format
+	template <class B>
+	void writeBlock(int index, const B & b) {
+		if (format == ChainFormat::JsonLines) {
+			write("{\"index\":");
+			writeNumber(index);
+			write(",\"version\":");
+			writeNumber(b.version);
+			write(",\"hash\":");
+			writeJsonString(b.hash);
+			write(",\"previousHash\":");
+			writeJsonString(b.previousHash);
+			write(",\"timestamp\":");
+			writeJsonString(b.timestamp);
+			write(",\"nonce\":");
+			writeNumber(b.nonce);
+			write(",\"transactions\":[");
+			bool first = true;
+			for (const auto & t : b.transactions) {
+				write(first ? "{\"from\":" : ",{\"from\":");
+				writeJsonString(t.fromAddress);
+				write(",\"to\":");
+				writeJsonString(t.toAddress);
+				write(",\"amount\":");
+				writeAmount(t.amount);
+				write("}");
+				first = false;
+			}
+			write("]}\n");
+		}
+		else {
+			write("Block ");
+			writeNumber(index);
+			write(": [ ");
+			for (const auto & t : b.transactions) {
+				write("(");
+				write(t.fromAddress);
+				write("->");
+				write(t.toAddress);
+				write(" : ");
+				writeAmount(t.amount);
+				write(") ");
+			}
+			write("]\n");
+		}
+	}
+
+	// PostCondition: buffered output handed to the stream
+	void flush() {
+		if (!buffer.empty()) {
+			os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+
+private:
+	void writeNumber(long long n) {
+		char digits[24];
+		int len = std::snprintf(digits, sizeof(digits), "%lld", n);
+		write(std::string_view(digits, static_cast<std::size_t>(len)));
+	}
+
+	// PostCondition: amount in cents written with two decimal places
+	void writeAmount(std::int64_t cents) {
+		char digits[24];
+		int len = formatCents(digits, sizeof(digits), cents);
+		write(std::string_view(digits, static_cast<std::size_t>(len)));
+	}
+
+	// PostCondition: s written as a quoted JSON string
+	void writeJsonString(std::string_view s) {
+		static const char hex[] = "0123456789abcdef";
+		write("\"");
+		std::size_t run = 0;	// start of characters not needing escapes
+		for (std::size_t i = 0; i < s.size(); i++) {
+			unsigned char c = static_cast<unsigned char>(s[i]);
+			if (c == '"' || c == '\\' || c < 0x20) {
+				write(s.substr(run, i - run));
+				if (c == '"' || c == '\\') {
+					char escaped[2] = { '\\', static_cast<char>(c) };
+					write(std::string_view(escaped, 2));
+				}
+				else {
+					char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+					write(std::string_view(escaped, 6));
+				}
+				run = i + 1;
+			}
+		}
+		write(s.substr(run));
+		write("\"");
+	}
+
+	std::ostream & os;		// destination of the output
+	ChainFormat format;		// how blocks are written
+	std::size_t chunkSize;	// bytes buffered before writing to os
+	std::string buffer;		// output not yet written to os
+};
+
+#endif /* CHAINWRITER_H */
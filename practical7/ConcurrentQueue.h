@@ -0,0 +1,163 @@
+/**
+ * ConcurrentQueue.h
+ *
+ * Lock-free multi producer, multi consumer FIFO queue (Michael & Scott).
+ * Like a LinkedList it is a chain of nodes behind a dummy header node, but
+ * the links are atomic and head and tail are advanced with compare and
+ * swap, so no thread ever blocks another. Dequeued nodes are reclaimed
+ * through HazardPointers.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#include "HazardPointers.h"
+
+#include <atomic>
+#include <utility>
+
+// ------------------ Node with an atomic link ---------------------------------
+template <class T>
+struct ConcurrentNode {
+	ConcurrentNode() : data(), next(nullptr) {}
+	ConcurrentNode(const T& d) : data(d), next(nullptr) {}
+	ConcurrentNode(T&& d) : data(std::move(d)), next(nullptr) {}
+
+	T data;
+	std::atomic<ConcurrentNode<T>*> next;
+};
+
+// ------------------------- The ConcurrentQueue Class ---------------------------
+template <class T>
+class ConcurrentQueue {
+public:
+	ConcurrentQueue();
+	~ConcurrentQueue();
+	ConcurrentQueue(const ConcurrentQueue<T> &) = delete;
+	ConcurrentQueue<T> & operator=(const ConcurrentQueue<T> &) = delete;
+
+	void enqueue(const T & value);
+	void enqueue(T && value);
+	bool tryDequeue(T & value);
+
+	int  size() const;
+	bool isEmpty() const;
+
+private:
+	void link(ConcurrentNode<T>* n);
+
+	std::atomic<ConcurrentNode<T>*> head;	// dummy node, head->next is the front item
+	std::atomic<ConcurrentNode<T>*> tail;	// last node (may lag one node behind)
+	std::atomic<int> count;					// number of items (approximate while in use)
+};
+
+// --------------- ConcurrentQueue Implementation -----------------------
+
+// PostCondition: empty queue containing only the dummy node
+template <class T>
+ConcurrentQueue<T>::ConcurrentQueue() : count{ 0 } {
+	ConcurrentNode<T>* dummy = new ConcurrentNode<T>();
+	head.store(dummy);
+	tail.store(dummy);
+}
+
+// PreCondition: no other thread is using the queue
+// PostCondition: all remaining nodes deleted
+template <class T>
+ConcurrentQueue<T>::~ConcurrentQueue() {
+	ConcurrentNode<T>* p = head.load();
+	while (p != nullptr) {
+		ConcurrentNode<T>* n = p->next.load();
+		delete p;
+		p = n;
+	}
+}
+
+// PostCondition: copy of value added to back of queue
+template <class T>
+void ConcurrentQueue<T>::enqueue(const T & value) {
+	link(new ConcurrentNode<T>(value));
+}
+
+// PostCondition: value moved to back of queue
+template <class T>
+void ConcurrentQueue<T>::enqueue(T && value) {
+	link(new ConcurrentNode<T>(std::move(value)));
+}
+
+// PostCondition: n linked after the last node and tail advanced
+template <class T>
+void ConcurrentQueue<T>::link(ConcurrentNode<T>* n) {
+	for (;;) {
+		ConcurrentNode<T>* last = HazardPointers::protect(0, tail);
+		ConcurrentNode<T>* next = last->next.load();
+		if (last != tail.load()) {
+			continue;
+		}
+		if (next == nullptr) {
+			if (last->next.compare_exchange_weak(next, n)) {
+				tail.compare_exchange_strong(last, n);	// may fail if another thread helped
+				break;
+			}
+		}
+		else {
+			tail.compare_exchange_weak(last, next);	// help a lagging tail along
+		}
+	}
+	HazardPointers::clear(0);
+	count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// PostCondition: if the queue is not empty the front item is moved into value
+//                and true returned, otherwise false returned
+template <class T>
+bool ConcurrentQueue<T>::tryDequeue(T & value) {
+	for (;;) {
+		ConcurrentNode<T>* first = HazardPointers::protect(0, head);
+		ConcurrentNode<T>* last = tail.load();
+		ConcurrentNode<T>* next = HazardPointers::protect(1, first->next);
+		if (first != head.load()) {
+			continue;
+		}
+		if (next == nullptr) {
+			HazardPointers::clear(0);
+			HazardPointers::clear(1);
+			return false;
+		}
+		if (first == last) {
+			tail.compare_exchange_weak(last, next);	// tail is lagging
+			continue;
+		}
+		if (head.compare_exchange_weak(first, next)) {
+			// next is now the dummy node, only this thread reads its data
+			value = std::move(next->data);
+			HazardPointers::clear(0);
+			HazardPointers::clear(1);
+			HazardPointers::retire(first);
+			count.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+}
+
+// PostCondition: returns number of items in the queue (approximate while in use)
+template <class T>
+int ConcurrentQueue<T>::size() const {
+	int n = count.load(std::memory_order_relaxed);
+	return (n > 0) ? n : 0;
+}
+
+// PostCondition: returns true if the queue has no items
+template <class T>
+bool ConcurrentQueue<T>::isEmpty() const {
+	ConcurrentNode<T>* first = HazardPointers::protect(0, head);
+	bool empty = (first->next.load() == nullptr);
+	HazardPointers::clear(0);
+	return empty;
+}
+
+#endif /* CONCURRENTQUEUE_H */
@@ -0,0 +1,442 @@
+/***********************************************************************
+ * Name        : DList.h
+ * Author      : agent@local
+ * Version     : 1.0
+ * Description : Doubly Linked List with a circular dummy header node and
+ *               bidirectional iterators. Insertion, erasure and splicing at
+ *               an iterator are O(1), positional access walks from the
+ *               nearer end.
+ ***********************************************************************/
+
+#ifndef DLIST_H
+#define DLIST_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+template <class T> class DList;
+
+// =============================== DLIST NODE =============================================
+template <class T>
+struct DNode {
+	DNode() : prev(this), next(this) {}
+	DNode(const T& d) : data(d), prev(nullptr), next(nullptr) {}
+	DNode(T&& d) : data(std::move(d)), prev(nullptr), next(nullptr) {}
+	template <class... Args>
+	DNode(std::in_place_t, Args&&... args) : data(std::forward<Args>(args)...), prev(nullptr), next(nullptr) {}
+
+	T data;
+	DNode<T>* prev;
+	DNode<T>* next;
+};
+
+// ============================= DLIST ITERATOR ===========================================
+
+// Bidirectional iterator, remains valid until the node it refers to is erased
+template <class T>
+class DListIterator {
+	public:
+		DListIterator(DNode<T> *start = nullptr) : current(start)	{}
+		T & operator*() const										{ return current->data; }
+		T * operator->() const										{ return &current->data; }
+		DListIterator & operator++()								{ current = current->next; return *(this); }
+		DListIterator operator++(int)								{ DListIterator tmp(*this); ++(*this); return tmp; }
+		DListIterator & operator--()								{ current = current->prev; return *(this); }
+		DListIterator operator--(int)								{ DListIterator tmp(*this); --(*this); return tmp; }
+
+		bool operator!=(const DListIterator & o) const				{ return current != o.current; }
+		bool operator==(const DListIterator & o) const				{ return current == o.current; }
+	private:
+		DNode<T> *current;
+		friend class DList<T>;
+};
+
+// ============================== DOUBLY LINKED LIST ======================================
+template <class T>
+class DList {
+public:
+	DList();
+	virtual ~DList();
+	DList(const DList<T> & other);
+	DList(DList<T> && other);
+	DList<T> & operator=(const DList<T> & other);
+	DList<T> & operator=(DList<T> && other) noexcept;
+	bool operator==(const DList<T> & other) const;
+
+	void clear();
+	void add(const T & value);
+	void add(T && value);
+	void add(int pos, const T & value);
+	void add(int pos, T && value);
+	template <class... Args> void emplace(Args&&... args);
+	void remove(int pos);
+	void set(int pos, const T & value);
+	T    get(int pos) const;
+	int  size() const;
+	bool isEmpty() const;
+
+	void print(std::ostream & os) const;
+	int  find(const T & value) const;
+
+	// Iterators
+	DListIterator<T> begin() const	{ return DListIterator<T>(header->next); }
+	DListIterator<T> end() const	{ return DListIterator<T>(header); }
+
+	// O(1) operations at an iterator
+	DListIterator<T> insert(DListIterator<T> itr, const T & value);
+	DListIterator<T> insert(DListIterator<T> itr, T && value);
+	DListIterator<T> erase(DListIterator<T> itr);
+	void splice(DListIterator<T> itr, DList<T> & other, DListIterator<T> element);
+	void splice(DListIterator<T> itr, DList<T> & other);
+
+	T & front() const;
+	T & back() const;
+	void removeFront();
+	void removeBack();
+
+private:
+	DNode<T>* nodeAt(int pos) const;
+	DNode<T>* link(DNode<T>* before, DNode<T>* n);
+	static void unlink(DNode<T>* n);
+	void swap(DList<T> & other);
+
+	DNode<T> *header;	// dummy header, header->next is first and header->prev is last
+	int count;
+};
+
+// ============================== DList Implementation ======================
+
+// Default Constructor
+template <class T>
+DList<T>::DList() : header{ new DNode<T>() }, count{ 0 } {}
+
+// Destructor
+template <class T>
+DList<T>::~DList() {
+	clear();
+	delete header;
+}
+
+// PostCondition: construct DList as a duplicate of other
+template <class T>
+DList<T>::DList(const DList<T> & other) : DList() {
+	for (DListIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+		add(*itr);
+	}
+}
+
+// PostCondition: construct DList by taking over the nodes of other, other is left empty
+//                (not noexcept as other is given a new header node)
+template <class T>
+DList<T>::DList(DList<T> && other) : DList() {
+	swap(other);
+}
+
+// PostCondition: assign other to DList
+template <class T>
+DList<T> & DList<T>::operator=(const DList<T> & other) {
+	if (this != &other) {
+		clear();
+		for (DListIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+			add(*itr);
+		}
+	}
+	return *this;
+}
+
+// PostCondition: nodes of other moved into DList, other is left empty
+template <class T>
+DList<T> & DList<T>::operator=(DList<T> && other) noexcept {
+	if (this != &other) {
+		clear();
+		swap(other);
+	}
+	return *this;
+}
+
+// PostCondition: nodes of this and other exchanged
+template <class T>
+void DList<T>::swap(DList<T> & other) {
+	std::swap(header, other.header);
+	std::swap(count, other.count);
+}
+
+// PostCondition: test DLists for equality
+template <class T>
+bool DList<T>::operator==(const DList<T> & other) const {
+	if (size() != other.size()) {
+		return false;
+	}
+	for (DListIterator<T> itr = begin(), oitr = other.begin(); itr != end(); ++itr, ++oitr) {
+		if ((*itr) != (*oitr)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// PostCondition: return number of elements in DList
+template <class T>
+int DList<T>::size() const {
+	return count;
+}
+
+// PostCondition: returns true if DList is empty
+template <class T>
+bool DList<T>::isEmpty() const {
+	return (count == 0);
+}
+
+// PostCondition: Node n linked in before Node before, returns n
+template <class T>
+DNode<T>* DList<T>::link(DNode<T>* before, DNode<T>* n) {
+	n->prev = before->prev;
+	n->next = before;
+	before->prev->next = n;
+	before->prev = n;
+	count++;
+	return n;
+}
+
+// PostCondition: Node n unlinked from its neighbours (count is not changed)
+template <class T>
+void DList<T>::unlink(DNode<T>* n) {
+	n->prev->next = n->next;
+	n->next->prev = n->prev;
+}
+
+// PreCondition:  pos >= 0 && pos <= count (count is the header)
+// PostCondition: returns Node at specified position, walking from the nearer end
+template <class T>
+DNode<T>* DList<T>::nodeAt(int pos) const {
+	DNode<T>* p = header;
+	if (pos < count / 2) {
+		for (int i = 0; i <= pos; i++) {
+			p = p->next;
+		}
+	}
+	else {
+		for (int i = count; i > pos; i--) {
+			p = p->prev;
+		}
+	}
+	return p;
+}
+
+// PreCondition: itr refers to a node of this DList or end()
+// PostCondition: value inserted before itr, returns iterator to new element
+template <class T>
+DListIterator<T> DList<T>::insert(DListIterator<T> itr, const T & value) {
+	return DListIterator<T>(link(itr.current, new DNode<T>(value)));
+}
+
+// PreCondition: itr refers to a node of this DList or end()
+// PostCondition: value moved into new element before itr, returns iterator to new element
+template <class T>
+DListIterator<T> DList<T>::insert(DListIterator<T> itr, T && value) {
+	return DListIterator<T>(link(itr.current, new DNode<T>(std::move(value))));
+}
+
+// PreCondition: itr refers to an element of this DList (not end())
+// PostCondition: element removed, returns iterator to the following element
+template <class T>
+DListIterator<T> DList<T>::erase(DListIterator<T> itr) {
+	if (itr.current == header || count == 0) {
+		throw std::out_of_range("DList: cannot erase end()");
+	}
+	DNode<T>* n = itr.current;
+	DNode<T>* next = n->next;
+	unlink(n);
+	count--;
+	delete n;
+	return DListIterator<T>(next);
+}
+
+// PreCondition: itr refers to a node of this DList or end(), element refers to an
+//               element of other (other may be this DList)
+// PostCondition: element moved from other to before itr without copying
+template <class T>
+void DList<T>::splice(DListIterator<T> itr, DList<T> & other, DListIterator<T> element) {
+	if (element.current == other.header || other.count == 0) {
+		throw std::out_of_range("DList: cannot splice end()");
+	}
+	DNode<T>* n = element.current;
+	if (n == itr.current || n->next == itr.current) {
+		return;		// already in position
+	}
+	unlink(n);
+	other.count--;
+	link(itr.current, n);
+}
+
+// PreCondition: itr refers to a node of this DList or end(), other is not this DList
+// PostCondition: all elements of other moved to before itr, other is left empty
+template <class T>
+void DList<T>::splice(DListIterator<T> itr, DList<T> & other) {
+	if (this == &other || other.count == 0) {
+		return;
+	}
+	DNode<T>* first = other.header->next;
+	DNode<T>* last = other.header->prev;
+	DNode<T>* before = itr.current;
+
+	first->prev = before->prev;
+	before->prev->next = first;
+	last->next = before;
+	before->prev = last;
+	count += other.count;
+
+	other.header->next = other.header->prev = other.header;
+	other.count = 0;
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: inserts element value at specified position
+template <class T>
+void DList<T>::add(int pos, const T & value) {
+	if (pos < 0 || pos > size()) {
+		throw std::out_of_range("DList invalid position: " + std::to_string(pos));
+	}
+	link(nodeAt(pos), new DNode<T>(value));
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: moves value into specified position
+template <class T>
+void DList<T>::add(int pos, T && value) {
+	if (pos < 0 || pos > size()) {
+		throw std::out_of_range("DList invalid position: " + std::to_string(pos));
+	}
+	link(nodeAt(pos), new DNode<T>(std::move(value)));
+}
+
+// PostCondition: inserts element value at end of DList
+template <class T>
+void DList<T>::add(const T & value) {
+	link(header, new DNode<T>(value));
+}
+
+// PostCondition: moves value to end of DList
+template <class T>
+void DList<T>::add(T && value) {
+	link(header, new DNode<T>(std::move(value)));
+}
+
+// PostCondition: element constructed from args added to end of DList
+template <class T>
+template <class... Args>
+void DList<T>::emplace(Args&&... args) {
+	link(header, new DNode<T>(std::in_place, std::forward<Args>(args)...));
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: deletes node at specified position
+template <class T>
+void DList<T>::remove(int pos) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("DList invalid position: " + std::to_string(pos));
+	}
+	erase(DListIterator<T>(nodeAt(pos)));
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: returns copy of element at pos
+template <class T>
+T DList<T>::get(int pos) const {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("DList invalid position: " + std::to_string(pos));
+	}
+	return nodeAt(pos)->data;
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: updates element at specified position
+template <class T>
+void DList<T>::set(int pos, const T & value) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("DList invalid position: " + std::to_string(pos));
+	}
+	nodeAt(pos)->data = value;
+}
+
+// PreCondition: DList is not empty
+// PostCondition: returns reference to first element
+template <class T>
+T & DList<T>::front() const {
+	if (count == 0) {
+		throw std::out_of_range("DList: empty");
+	}
+	return header->next->data;
+}
+
+// PreCondition: DList is not empty
+// PostCondition: returns reference to last element
+template <class T>
+T & DList<T>::back() const {
+	if (count == 0) {
+		throw std::out_of_range("DList: empty");
+	}
+	return header->prev->data;
+}
+
+// PreCondition: DList is not empty
+// PostCondition: first element removed
+template <class T>
+void DList<T>::removeFront() {
+	erase(begin());
+}
+
+// PreCondition: DList is not empty
+// PostCondition: last element removed
+template <class T>
+void DList<T>::removeBack() {
+	erase(DListIterator<T>(header->prev));
+}
+
+// PostCondition: returns index of item if found or -1 if not found
+template <class T>
+int DList<T>::find(const T & value) const {
+	int i = 0;
+	for (DListIterator<T> itr = begin(); itr != end(); itr++, i++) {
+		if ((*itr) == value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// PostCondition: DList is emptied count == 0;
+template <class T>
+void DList<T>::clear() {
+	DNode<T>* p = header->next;
+	while (p != header) {
+		DNode<T>* n = p->next;
+		delete p;
+		p = n;
+	}
+	header->next = header->prev = header;
+	count = 0;
+}
+
+// PostCondition: prints contents of DList to ostream
+template <class T>
+void DList<T>::print(std::ostream & os) const {
+	os << "[ ";
+	for (DListIterator<T> itr = begin(); itr != end(); ++itr) {
+		os << (*itr) << " ";
+	}
+	os << "]";
+}
+
+// PreCondition: None
+// PostCondition: overload << operator to output DList on ostream
+template <class T>
+std::ostream& operator <<(std::ostream& output, const DList<T>& l) {
+	l.print(output);
+	return output;  // for multiple << operators.
+}
+
+#endif /* DLIST_H */
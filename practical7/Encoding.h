@@ -0,0 +1,130 @@
+/**
+ * Encoding.h
+ *
+ * Binary encoding of blocks, used for the hash input of version 2 blocks
+ * and for the records of the block store. Integers are little endian and
+ * strings are prefixed with their 4 byte length. Amounts are whole cents,
+ * given a decimal point only when formatted as text.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.1
+ */
+
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <cmath>		// std::llround
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>		// std::snprintf
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// PostCondition: v appended to out as 4 bytes
+inline void encodeU32(std::string & out, std::uint32_t v) {
+	for (int i = 0; i < 4; i++) {
+		out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+	}
+}
+
+// PostCondition: v appended to out as 8 bytes
+inline void encodeI64(std::string & out, std::int64_t v) {
+	std::uint64_t u = static_cast<std::uint64_t>(v);
+	for (int i = 0; i < 8; i++) {
+		out.push_back(static_cast<char>((u >> (8 * i)) & 0xff));
+	}
+}
+
+// PostCondition: length of s then the bytes of s appended to out
+inline void encodeString(std::string & out, std::string_view s) {
+	encodeU32(out, static_cast<std::uint32_t>(s.size()));
+	out.append(s);
+}
+
+// ------------------ Amounts held as a whole number of cents ------------------
+
+// PostCondition: returns amount (in currency units) rounded to the nearest cent
+inline std::int64_t amountToCents(double amount) {
+	return std::llround(amount * 100);
+}
+
+// PostCondition: cents written to out with two decimal places ("-12.05"), the text
+//                std::fixed << setprecision(2) gave for the amount, returns the number
+//                of characters written (24 bytes always suffice)
+inline int formatCents(char * out, std::size_t size, std::int64_t cents) {
+	std::uint64_t magnitude = (cents < 0) ? 0 - static_cast<std::uint64_t>(cents) : static_cast<std::uint64_t>(cents);
+	return std::snprintf(out, size, "%s%llu.%02llu", (cents < 0) ? "-" : "",
+		static_cast<unsigned long long>(magnitude / 100), static_cast<unsigned long long>(magnitude % 100));
+}
+
+// PostCondition: returns cents as text with two decimal places
+inline std::string formatCents(std::int64_t cents) {
+	char digits[24];
+	int len = formatCents(digits, sizeof(digits), cents);
+	return std::string(digits, static_cast<std::size_t>(len));
+}
+
+// ------------------ Reads encoded values from a buffer -----------------------
+// Each read throws std::runtime_error if the buffer does not hold enough bytes
+class BinaryReader {
+public:
+	BinaryReader(const char * data, std::size_t size) : p(data), end(data + size) {}
+
+	std::uint8_t u8() {
+		need(1);
+		return static_cast<std::uint8_t>(*p++);
+	}
+
+	std::uint32_t u32() {
+		need(4);
+		std::uint32_t v = 0;
+		for (int i = 0; i < 4; i++) {
+			v |= static_cast<std::uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+		}
+		p += 4;
+		return v;
+	}
+
+	std::int64_t i64() {
+		need(8);
+		std::uint64_t v = 0;
+		for (int i = 0; i < 8; i++) {
+			v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+		}
+		p += 8;
+		return static_cast<std::int64_t>(v);
+	}
+
+	// PostCondition: returns pointer to the next n bytes and skips over them
+	const char * bytes(std::size_t n) {
+		need(n);
+		const char * b = p;
+		p += n;
+		return b;
+	}
+
+	// PostCondition: returns length prefixed string viewed in place in the buffer
+	std::string_view string() {
+		std::uint32_t n = u32();
+		return std::string_view(bytes(n), n);
+	}
+
+	// PostCondition: returns number of bytes not yet read
+	std::size_t remaining() const {
+		return static_cast<std::size_t>(end - p);
+	}
+
+private:
+	void need(std::size_t n) const {
+		if (remaining() < n) {
+			throw std::runtime_error("BinaryReader: unexpected end of data");
+		}
+	}
+
+	const char * p;		// next byte to read
+	const char * end;	// end of buffer
+};
+
+#endif /* ENCODING_H */
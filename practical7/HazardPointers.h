@@ -0,0 +1,187 @@
+/**
+ * HazardPointers.h
+ *
+ * Safe memory reclamation for lock-free data structures. Before a thread
+ * dereferences a shared node it publishes the pointer in one of its hazard
+ * slots, a node removed from a structure is retired rather than deleted and
+ * is only freed once no thread has it published.
+ *
+ * Each thread claims a record the first time it protects a pointer and
+ * releases it when the thread exits, nodes it retired that are still in use
+ * are handed to the domain and freed by a later scan.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef HAZARDPOINTERS_H
+#define HAZARDPOINTERS_H
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+class HazardPointers {
+public:
+	const static int MAXTHREADS = 128;	// threads that may hold hazard pointers at once
+	const static int SLOTS = 3;			// hazard pointers per thread (a structure uses its own)
+
+	// PreCondition:  slot >= 0 && slot < SLOTS
+	// PostCondition: returns the current value of src, published in slot so it will
+	//                not be freed until the slot is cleared or reused
+	template <class P>
+	static P* protect(int slot, const std::atomic<P*> & src) {
+		std::atomic<void*> & hazard = local().record->hazard[slot];
+		P* p = src.load();
+		for (;;) {
+			hazard.store(p);
+			P* again = src.load();	// confirm p was not removed before it was published
+			if (again == p) {
+				return p;
+			}
+			p = again;
+		}
+	}
+
+	// PostCondition: hazard pointer in slot cleared
+	static void clear(int slot) {
+		local().record->hazard[slot].store(nullptr, std::memory_order_release);
+	}
+
+	// PreCondition:  p has been removed from the shared structure
+	// PostCondition: p will be deleted once no thread has it published
+	template <class P>
+	static void retire(P* p) {
+		ThreadState & state = local();
+		state.retired.push_back(Retired{ p, [](void* q) { delete static_cast<P*>(q); } });
+		if (static_cast<int>(state.retired.size()) >= RETIRETHRESHOLD) {
+			scan(state.retired);
+		}
+	}
+
+	// PostCondition: nodes retired by the calling thread that no thread has published
+	//                are deleted now, without waiting for the retire threshold
+	static void reclaim() {
+		scan(local().retired);
+	}
+
+private:
+	const static int RETIRETHRESHOLD = 2 * MAXTHREADS * SLOTS;	// retired nodes before a scan
+
+	struct Record {
+		std::atomic<bool> active{ false };
+		std::atomic<void*> hazard[SLOTS];
+	};
+
+	struct Retired {
+		void* ptr;
+		void (*deleter)(void*);
+	};
+
+	// per thread record and list of retired nodes
+	struct ThreadState {
+		ThreadState() : record(domain().acquire()) {}
+		~ThreadState() {
+			for (int i = 0; i < SLOTS; i++) {
+				record->hazard[i].store(nullptr);
+			}
+			scan(retired);
+			domain().orphan(retired);	// nodes still in use freed by a later scan
+			record->active.store(false, std::memory_order_release);
+		}
+		Record* record;
+		std::vector<Retired> retired;
+	};
+
+	// records of all threads and nodes retired by threads that have exited
+	struct Domain {
+		Record records[MAXTHREADS];
+		std::mutex orphanLock;
+		std::vector<Retired> orphans;
+
+		Domain() {
+			for (Record & r : records) {
+				for (int i = 0; i < SLOTS; i++) {
+					r.hazard[i].store(nullptr);
+				}
+			}
+		}
+
+		// PostCondition: all nodes still retired are freed (no threads remain)
+		~Domain() {
+			for (Retired & r : orphans) {
+				r.deleter(r.ptr);
+			}
+		}
+
+		// PostCondition: returns an unused record claimed by the calling thread
+		Record* acquire() {
+			for (Record & r : records) {
+				bool expected = false;
+				if (!r.active.load(std::memory_order_relaxed) && r.active.compare_exchange_strong(expected, true)) {
+					return &r;
+				}
+			}
+			throw std::runtime_error("HazardPointers: too many threads");
+		}
+
+		// PostCondition: retired nodes handed over to the domain
+		void orphan(std::vector<Retired> & retired) {
+			std::lock_guard<std::mutex> guard(orphanLock);
+			orphans.insert(orphans.end(), retired.begin(), retired.end());
+			retired.clear();
+		}
+
+		// PostCondition: orphaned nodes moved to retired
+		void adopt(std::vector<Retired> & retired) {
+			std::unique_lock<std::mutex> guard(orphanLock, std::try_to_lock);
+			if (guard.owns_lock() && !orphans.empty()) {
+				retired.insert(retired.end(), orphans.begin(), orphans.end());
+				orphans.clear();
+			}
+		}
+	};
+
+	static Domain & domain() {
+		static Domain d;
+		return d;
+	}
+
+	static ThreadState & local() {
+		thread_local ThreadState state;
+		return state;
+	}
+
+	// PostCondition: retired nodes not published by any thread are deleted
+	static void scan(std::vector<Retired> & retired) {
+		Domain & d = domain();
+		d.adopt(retired);
+
+		std::vector<void*> hazards;
+		for (Record & r : d.records) {
+			for (int i = 0; i < SLOTS; i++) {
+				void* p = r.hazard[i].load();
+				if (p != nullptr) {
+					hazards.push_back(p);
+				}
+			}
+		}
+		std::sort(hazards.begin(), hazards.end());
+
+		std::vector<Retired> keep;
+		for (Retired & r : retired) {
+			if (std::binary_search(hazards.begin(), hazards.end(), r.ptr)) {
+				keep.push_back(r);
+			}
+			else {
+				r.deleter(r.ptr);
+			}
+		}
+		retired.swap(keep);
+	}
+};
+
+#endif /* HAZARDPOINTERS_H */
@@ -3,7 +3,8 @@
  * Author      : a.mccaughey@ulster.ac.uk
  * Version     : 1.3.2
  * Description : Advanced Head/Tail Dynamic Linked LinkedList class with
- *               exception handling and public Node and Iterator classes
+ *               exception handling and public Node and Iterator classes.
+ *               Nodes are allocated from a NodePool of contiguous chunks
  ***********************************************************************/
 
 #ifndef LINKEDLIST_H
@@ -12,17 +13,119 @@
 #include <cstdlib> // Defines NULL
 #include <iostream>
 #include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // =============================== LIST NODE ==============================================
 // Node Class Used as Building Blocks of a LinkedList
 template <class T>
 struct Node {
     Node(const T& d = T(), Node<T>* n = nullptr) : data(d), next(n) { }
+    Node(T&& d, Node<T>* n = nullptr) : data(std::move(d)), next(n) { }
+    template <class... Args>
+    Node(std::in_place_t, Args&&... args) : data(std::forward<Args>(args)...), next(nullptr) { }
 
     T data;
     Node<T>* next;
 };
 
+// =============================== NODE POOL ==============================================
+// Slab allocator for Nodes. Nodes are carved from contiguous chunks (each twice
+// the size of the previous, up to maxChunk nodes) and recycled through a free list.
+// A pool may be owned by one LinkedList or shared between several.
+template <class T>
+class NodePool {
+public:
+	explicit NodePool(int maxChunk = 1024) : freeList(nullptr), next(nullptr), last(nullptr),
+		chunkSize(8), maxChunk(maxChunk > 8 ? maxChunk : 8), live(0) {}
+	~NodePool() { release(); }
+	NodePool(const NodePool<T> &) = delete;
+	NodePool<T> & operator=(const NodePool<T> &) = delete;
+
+	// PostCondition: returns Node constructed from args in pooled storage
+	template <class... Args>
+	Node<T>* create(Args&&... args) {
+		Node<T>* n = new (allocate()) Node<T>(std::forward<Args>(args)...);
+		live++;
+		return n;
+	}
+
+	// PreCondition: n was created by this pool
+	// PostCondition: Node destroyed and its storage recycled
+	void destroy(Node<T>* n) {
+		n->~Node<T>();
+		Slot* s = reinterpret_cast<Slot*>(n);
+		s->nextFree = freeList;
+		freeList = s;
+		live--;
+	}
+
+	// PreCondition: first is a chain of Nodes created by this pool, terminated by nullptr
+	// PostCondition: every Node of the chain destroyed in a single forward pass and
+	//                its storage recycled, returns number of Nodes recycled
+	int destroyChain(Node<T>* first) {
+		int n = 0;
+		while (first != nullptr) {
+			Node<T>* next = first->next;
+			destroy(first);
+			first = next;
+			n++;
+		}
+		return n;
+	}
+
+	// PreCondition: no Nodes created by this pool are still in use
+	// PostCondition: all chunks returned to the heap
+	void release() {
+		for (Slot* chunk : chunks) {
+			::operator delete(chunk);
+		}
+		chunks.clear();
+		freeList = next = last = nullptr;
+		chunkSize = 8;
+		live = 0;
+	}
+
+	// PostCondition: returns number of Nodes currently in use
+	int liveNodes() const	{ return live; }
+
+	// PostCondition: returns number of chunks allocated
+	int chunkCount() const	{ return static_cast<int>(chunks.size()); }
+
+private:
+	union Slot {
+		Slot* nextFree;
+		alignas(Node<T>) unsigned char storage[sizeof(Node<T>)];
+	};
+
+	// PostCondition: returns storage for one Node, from free list or current chunk
+	void* allocate() {
+		if (freeList != nullptr) {
+			Slot* s = freeList;
+			freeList = s->nextFree;
+			return s;
+		}
+		if (next == last) {
+			// current chunk exhausted so allocate a new (larger) one
+			next = static_cast<Slot*>(::operator new(sizeof(Slot) * chunkSize));
+			last = next + chunkSize;
+			chunks.push_back(next);
+			chunkSize = (chunkSize * 2 <= maxChunk) ? chunkSize * 2 : maxChunk;
+		}
+		return next++;
+	}
+
+	Slot* freeList;				// recycled slots
+	Slot* next;					// next unused slot of current chunk
+	Slot* last;					// end of current chunk
+	std::vector<Slot*> chunks;	// all chunks allocated
+	int chunkSize;				// size of next chunk
+	int maxChunk;				// largest chunk size
+	int live;					// nodes in use
+};
+
 // ============================= LIST ITERATOR ============================================
 
 // List Iterator Class , used to efficiently traverse through a List
@@ -46,14 +149,20 @@ template <class T>
 class LinkedList {
 public:
     LinkedList();
+    explicit LinkedList(NodePool<T> & sharedPool);
     virtual ~LinkedList();
     LinkedList(const LinkedList<T> & other);
-	void operator=(const LinkedList<T> & other);
+    LinkedList(LinkedList<T> && other);
+	LinkedList<T> & operator=(const LinkedList<T> & other);
+	LinkedList<T> & operator=(LinkedList<T> && other);
 	bool operator==(const LinkedList<T> & other) const;
 	
-    void clear();
+    void clear(bool releaseNodes = true);
 	void add(const T & value);
+	void add(T && value);
     void add(int pos, const T & value);
+    void add(int pos, T && value);
+	template <class... Args> void emplace(Args&&... args);
     void remove(int pos);
     void set(int pos, const T & value);
     T    get(int pos) const;
@@ -72,35 +181,78 @@ public:
 private:
 	Node<T>* nodeAt(int pos) const;
 	void deepCopy(const LinkedList<T> & c);
+	void assign(const LinkedList<T> & c);
+	void insertNode(int pos, Node<T>* n);
+	void swap(LinkedList<T> & other);
+	template <class... Args> Node<T>* createNode(Args&&... args);
 
     Node<T> *header, *tail;
     int count;
+	NodePool<T> *pool;	// allocator for Nodes (created on first use when owned)
+	bool ownsPool;		// true if pool is private to this LinkedList
 };
 
 // ============================== LinkedList Implementation ======================
 
 // Default Constructor
 template <class T>
-LinkedList<T>::LinkedList() {
+LinkedList<T>::LinkedList() : pool{ nullptr }, ownsPool{ true } {
 	header = new Node<T>();
 	tail = header;			// TAIL POINTS TO HEADER
 	count = 0;
 }
 
+// PostCondition: empty LinkedList allocating its Nodes from sharedPool
+template <class T>
+LinkedList<T>::LinkedList(NodePool<T> & sharedPool) : LinkedList() {
+	pool = &sharedPool;
+	ownsPool = false;
+}
+
 // Destructor
 template <class T>
 LinkedList<T>::~LinkedList() {
-    clear();
+	if (ownsPool) {
+		// destroy elements (unless trivial) then free private node chunks
+		if (!std::is_trivially_destructible<T>::value) {
+			for (Node<T>* p = header->next; p != nullptr; ) {
+				Node<T>* n = p->next;
+				p->~Node<T>();
+				p = n;
+			}
+		}
+		delete pool;
+	}
+	else {
+		clear();		// hand nodes back to shared pool
+	}
 	delete header; // delete dummy header node
 }
 
 // PostCondition: construct LinkedList as a duplicate of c
 template <class T>
-LinkedList<T>::LinkedList(const LinkedList<T> & other) {
+LinkedList<T>::LinkedList(const LinkedList<T> & other) : pool{ nullptr }, ownsPool{ true } {
 	header = new Node<T>;	// create dummy header
     deepCopy(other);			// create a deep copy of other
 }
 
+// PostCondition: returns new Node constructed from args using the pool
+template <class T>
+template <class... Args>
+Node<T>* LinkedList<T>::createNode(Args&&... args) {
+	if (pool == nullptr) {
+		pool = new NodePool<T>();	// private pool created on first use
+	}
+	return pool->create(std::forward<Args>(args)...);
+}
+
+// PostCondition: construct LinkedList by taking over the nodes of other, other is left empty
+//                (not noexcept as other is given a new header node)
+template <class T>
+LinkedList<T>::LinkedList(LinkedList<T> && other) : LinkedList() {
+	swap(other);
+}
+
 // PreCondition: c refers to a LinkedLinkedList
 // PostCondition: perform a deep copy of c
 template <class T>
@@ -109,7 +261,7 @@ void LinkedList<T>::deepCopy(const LinkedList<T> & c) {
     Node<T>* prev = header;
     Node<T>* n;			// new Node reference
     while (cc != NULL) {
-        n = new Node<T>(cc->data, prev->next);
+        n = createNode(cc->data, prev->next);
         prev->next = n;	// set last to refer to n
         prev = n;		// set last to n
         cc = cc->next;	// move to next Node in c
@@ -121,9 +273,56 @@ void LinkedList<T>::deepCopy(const LinkedList<T> & c) {
 
 // PostCondition: assign c to LinkedList
 template<class T>
-void LinkedList<T>::operator=(const LinkedList<T> & other) {
-	clear();		// clear existing LinkedList
-	deepCopy(other);	// perform a deep copy
+LinkedList<T> & LinkedList<T>::operator=(const LinkedList<T> & other) {
+	if (this != &other) {
+		assign(other);	// copy into existing nodes
+	}
+	return *this;
+}
+
+// PostCondition: LinkedList holds a copy of c, existing Nodes are reused and only
+//                the difference in length is allocated or recycled
+template <class T>
+void LinkedList<T>::assign(const LinkedList<T> & c) {
+	Node<T>* cc = c.header->next;
+	Node<T>* prev = header;
+	while (cc != nullptr && prev->next != nullptr) {
+		prev = prev->next;
+		prev->data = cc->data;	// overwrite existing element
+		cc = cc->next;
+	}
+	if (prev->next != nullptr) {
+		// c is shorter so recycle remaining nodes
+		pool->destroyChain(prev->next);
+		prev->next = nullptr;
+	}
+	while (cc != nullptr) {
+		prev->next = createNode(cc->data);
+		prev = prev->next;
+		cc = cc->next;
+	}
+	tail = prev;
+	count = c.count;
+}
+
+// PostCondition: nodes of other moved into LinkedList, other is left empty
+template<class T>
+LinkedList<T> & LinkedList<T>::operator=(LinkedList<T> && other) {
+	if (this != &other) {
+		clear();		// clear existing LinkedList
+		swap(other);	// take over nodes of other
+	}
+	return *this;
+}
+
+// PostCondition: nodes of this and other exchanged
+template<class T>
+void LinkedList<T>::swap(LinkedList<T> & other) {
+	std::swap(header, other.header);
+	std::swap(tail, other.tail);
+	std::swap(count, other.count);
+	std::swap(pool, other.pool);
+	std::swap(ownsPool, other.ownsPool);
 }
 
 // PostCondition: test LinkedLists for equality
@@ -163,8 +362,25 @@ void LinkedList<T>::add(int pos, const T & value) {
 	if (pos < 0 || pos > size()) {
 		throw std::out_of_range("LinkedList invalid position: " + std::to_string(pos));
 	}
+	insertNode(pos, createNode(value));
+}
+
+// PreCondition: pos is a valid insertion LinkedList position
+// PostCondition: moves value into a new Node at specified position in linked LinkedList
+template<class T>
+void LinkedList<T>::add(int pos, T && value) {
+	if (pos < 0 || pos > size()) {
+		throw std::out_of_range("LinkedList invalid position: " + std::to_string(pos));
+	}
+	insertNode(pos, createNode(std::move(value)));
+}
+
+// PreCondition: pos is a valid insertion LinkedList position
+// PostCondition: links Node n into specified position in linked LinkedList
+template<class T>
+void LinkedList<T>::insertNode(int pos, Node<T>* n) {
  	Node<T>* prev = nodeAt(pos - 1);
-	Node<T>* n = new Node<T> (value, prev->next);
+	n->next = prev->next;
 	prev->next = n;
 	if (pos == count) {tail = n;}           // INSERTED AT END SO UPDATE TAIL
 	count++;	
@@ -176,6 +392,19 @@ void LinkedList<T>::add(const T & value) {
 	add(size(),value);
 }
 
+// PostCondition: moves value to end of linked LinkedList
+template<class T>
+void LinkedList<T>::add(T && value) {
+	add(size(), std::move(value));
+}
+
+// PostCondition: element constructed from args added to end of linked LinkedList
+template<class T>
+template<class... Args>
+void LinkedList<T>::emplace(Args&&... args) {
+	insertNode(size(), createNode(std::in_place, std::forward<Args>(args)...));
+}
+
 
 // PreCondition: pos is a valid LinkedList position
 // PostCondition: deletes Node at specified position in linked LinkedList
@@ -189,7 +418,7 @@ void LinkedList<T>::remove(int pos) {
 	prev->next = curr->next;				// set prev to refer to next node
 	if (pos == count - 1) { tail = prev; }	// IF LAST NODE DELETED UPDATE TAIL
 	count--;								// reduce number of elements in LinkedList
-	delete curr;							// delete Node referred to by curr
+	pool->destroy(curr);					// recycle Node referred to by curr
 }
 
 // PreCondition: pos is a valid LinkedList position
@@ -276,11 +505,30 @@ Node<T>* LinkedList<T>::nodeAt(int pos) const {
 }
 
 // PostCondition: LinkedList is emptied count == 0;
+// Nodes are released in a single forward pass, a private pool is then
+// returned to the heap a whole chunk at a time unless releaseNodes is false,
+// in which case the nodes are kept in the pool for reuse by later adds
 template<class T>
-void LinkedList<T>::clear() {
-	for (int i = size() - 1; i >= 0; i--) {
-		remove(i);
+void LinkedList<T>::clear(bool releaseNodes) {
+	Node<T>* p = header->next;
+	if (ownsPool && pool != nullptr && releaseNodes) {
+		// destroy elements (unless trivial) then free chunks
+		if (!std::is_trivially_destructible<T>::value) {
+			while (p != nullptr) {
+				Node<T>* n = p->next;
+				p->~Node<T>();
+				p = n;
+			}
+		}
+		pool->release();
 	}
+	else if (pool != nullptr) {
+		// shared pool, or nodes kept, so recycle each node
+		pool->destroyChain(p);
+	}
+	header->next = nullptr;
+	tail = header;
+	count = 0;
 }
 
 //PostCondition: returns countgth of LinkedList
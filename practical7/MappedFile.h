@@ -0,0 +1,262 @@
+/**
+ * MappedFile.h
+ *
+ * Minimal platform file access used by the block store. MappedFile maps a
+ * whole file read only into memory, AppendFile appends to a file and
+ * forces written data to disk. POSIX and Windows are supported.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <direct.h>		// _mkdir
+#include <fcntl.h>
+#include <io.h>			// _open, _write, _commit
+#include <sys/stat.h>
+#include <sys/types.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>	// mmap
+#include <sys/stat.h>
+#include <unistd.h>		// write, fsync
+#endif
+
+// ------------------ Read only memory mapping of a whole file -------------------
+class MappedFile {
+public:
+	MappedFile() : addr(nullptr), length(0) {}
+	explicit MappedFile(const std::string & path) : MappedFile() { open(path); }
+	~MappedFile() { close(); }
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile && other) noexcept : addr(other.addr), length(other.length) {
+		other.addr = nullptr;
+		other.length = 0;
+	}
+	MappedFile & operator=(MappedFile && other) noexcept {
+		if (this != &other) {
+			close();
+			std::swap(addr, other.addr);
+			std::swap(length, other.length);
+		}
+		return *this;
+	}
+
+	// PostCondition: contents of file at path mapped (an empty file maps no memory),
+	//                returns false if the file does not exist
+	bool open(const std::string & path) {
+		close();
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER size;
+		GetFileSizeEx(file, &size);
+		length = static_cast<std::size_t>(size.QuadPart);
+		if (length > 0) {
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr) {
+				addr = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);	// view keeps the mapping alive
+			}
+		}
+		CloseHandle(file);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat st;
+		fstat(fd, &st);
+		length = static_cast<std::size_t>(st.st_size);
+		if (length > 0) {
+			void * p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+			addr = (p != MAP_FAILED) ? static_cast<const char *>(p) : nullptr;
+		}
+		::close(fd);
+#endif
+		if (length > 0 && addr == nullptr) {
+			length = 0;
+			throw std::runtime_error("MappedFile: cannot map " + path);
+		}
+		return true;
+	}
+
+	// PostCondition: mapping released
+	void close() {
+		if (addr != nullptr) {
+#if defined(_WIN32)
+			UnmapViewOfFile(addr);
+#else
+			munmap(const_cast<char *>(addr), length);
+#endif
+		}
+		addr = nullptr;
+		length = 0;
+	}
+
+	const char * data() const	{ return addr; }
+	std::size_t size() const	{ return length; }
+
+private:
+	const char * addr;		// start of mapped contents
+	std::size_t length;		// bytes mapped
+};
+
+// ------------------ File opened for appending -----------------------------------
+class AppendFile {
+public:
+	AppendFile() : fd(-1), length(0) {}
+	~AppendFile() { close(); }
+	AppendFile(const AppendFile &) = delete;
+	AppendFile & operator=(const AppendFile &) = delete;
+
+	// PostCondition: file at path opened for appending, created if it does not exist
+	void open(const std::string & path) {
+		close();
+#if defined(_WIN32)
+		fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+		if (fd < 0) {
+			throw std::runtime_error("AppendFile: cannot open " + path);
+		}
+		length = fileSize(path);
+	}
+
+	// PostCondition: file closed
+	void close() {
+		if (fd >= 0) {
+#if defined(_WIN32)
+			_close(fd);
+#else
+			::close(fd);
+#endif
+		}
+		fd = -1;
+		length = 0;
+	}
+
+	// PostCondition: n bytes of data appended to the file (not necessarily on disk)
+	void write(const char * data, std::size_t n) {
+		while (n > 0) {
+#if defined(_WIN32)
+			int written = _write(fd, data, static_cast<unsigned int>(n));
+#else
+			ssize_t written = ::write(fd, data, n);
+#endif
+			if (written <= 0) {
+				throw std::runtime_error("AppendFile: write failed");
+			}
+			data += written;
+			n -= static_cast<std::size_t>(written);
+			length += static_cast<std::size_t>(written);
+		}
+	}
+
+	// PostCondition: all data written so far is on disk
+	void sync() {
+#if defined(_WIN32)
+		int result = _commit(fd);
+#else
+		int result = fsync(fd);
+#endif
+		if (result != 0) {
+			throw std::runtime_error("AppendFile: sync failed");
+		}
+	}
+
+	bool isOpen() const			{ return fd >= 0; }
+	std::size_t size() const	{ return length; }
+
+	// PostCondition: returns size of file at path, 0 if it does not exist
+	static std::size_t fileSize(const std::string & path) {
+#if defined(_WIN32)
+		struct _stat64 st;
+		return (_stat64(path.c_str(), &st) == 0) ? static_cast<std::size_t>(st.st_size) : 0;
+#else
+		struct stat st;
+		return (stat(path.c_str(), &st) == 0) ? static_cast<std::size_t>(st.st_size) : 0;
+#endif
+	}
+
+	// PostCondition: returns true if a file exists at path
+	static bool exists(const std::string & path) {
+#if defined(_WIN32)
+		struct _stat64 st;
+		return _stat64(path.c_str(), &st) == 0;
+#else
+		struct stat st;
+		return stat(path.c_str(), &st) == 0;
+#endif
+	}
+
+	// PostCondition: file at path cut to size bytes
+	static void truncate(const std::string & path, std::size_t size) {
+#if defined(_WIN32)
+		int f = _open(path.c_str(), _O_WRONLY | _O_BINARY);
+		bool ok = f >= 0 && _chsize_s(f, static_cast<long long>(size)) == 0;
+		if (f >= 0) {
+			_close(f);
+		}
+#else
+		bool ok = ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+		if (!ok) {
+			throw std::runtime_error("AppendFile: cannot truncate " + path);
+		}
+	}
+
+	// PostCondition: directory at path exists
+	static void makeDirectory(const std::string & path) {
+		if (!exists(path)) {
+#if defined(_WIN32)
+			int result = _mkdir(path.c_str());
+#else
+			int result = mkdir(path.c_str(), 0755);
+#endif
+			if (result != 0) {
+				throw std::runtime_error("AppendFile: cannot create directory " + path);
+			}
+		}
+	}
+
+	// PostCondition: entries created in directory at path are durable
+	static void syncDirectory(const std::string & path) {
+#if defined(_WIN32)
+		(void)path;		// NTFS journals directory entries, nothing to sync
+#else
+		int dir = ::open(path.c_str(), O_RDONLY | O_DIRECTORY);
+		bool ok = dir >= 0 && fsync(dir) == 0;
+		if (dir >= 0) {
+			::close(dir);
+		}
+		if (!ok) {
+			throw std::runtime_error("AppendFile: cannot sync directory " + path);
+		}
+#endif
+	}
+
+private:
+	int fd;				// file descriptor
+	std::size_t length;	// current size of file
+};
+
+#endif /* MAPPEDFILE_H */
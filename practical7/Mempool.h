@@ -0,0 +1,226 @@
+/**
+ * Mempool.h
+ *
+ * Generic pool of pending items (transactions waiting to be mined).
+ * Items are held in a growable ring buffer so taking from the front is O(1)
+ * and batches are moved out without copying. Optionally items are taken in
+ * priority order (highest first, ties in arrival order) using a binary heap.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include "ArrayList.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <class T>
+class Mempool {
+public:
+	typedef double (*PriorityFunction)(const T & item);	// larger values taken first
+
+	explicit Mempool(PriorityFunction priority = nullptr);
+
+	void setPriority(PriorityFunction priority);
+	void add(const T & value);
+	void add(T && value);
+	T    popFront();
+	const T & front() const;
+	int  takeBatch(int n, ArrayList<T> & out);
+	void clear();
+
+	int  size() const;
+	bool isEmpty() const;
+	void print(std::ostream & os) const;
+
+private:
+	struct Entry {
+		T value;
+		double key;			// priority of value
+		long long seq;		// arrival order
+	};
+
+	// PostCondition: returns true if a should be taken after b
+	static bool takenAfter(const Entry & a, const Entry & b) {
+		return a.key < b.key || (a.key == b.key && a.seq > b.seq);
+	}
+
+	void push(T && value, double key);
+	void grow();
+	Entry & at(int i)				{ return slots[(head + i) & (slots.size() - 1)]; }
+	const Entry & at(int i) const	{ return slots[(head + i) & (slots.size() - 1)]; }
+
+	std::vector<Entry> slots;	// ring buffer (FIFO) or heap (priority), size is a power of 2
+	int head;					// position of first item in ring buffer (always 0 for heap)
+	int count;					// number of items in pool
+	long long nextSeq;			// arrival number of next item
+	PriorityFunction priority;	// nullptr for FIFO order
+};
+
+// --------------- Mempool Implementation -----------------------
+
+// PostCondition: empty pool taking items in FIFO order, or by priority if supplied
+template <class T>
+Mempool<T>::Mempool(PriorityFunction priority) : slots(16), head{ 0 }, count{ 0 },
+	nextSeq{ 0 }, priority{ priority } {}
+
+// PostCondition: pool reordered so items are taken by priority (or FIFO if nullptr)
+template <class T>
+void Mempool<T>::setPriority(PriorityFunction p) {
+	// linearise items in arrival order
+	std::vector<Entry> items;
+	items.reserve(slots.size());
+	for (int i = 0; i < count; i++) {
+		items.push_back(std::move(at(i)));
+	}
+	std::sort(items.begin(), items.end(), [](const Entry & a, const Entry & b) { return a.seq < b.seq; });
+
+	priority = p;
+	for (Entry & e : items) {
+		e.key = (priority != nullptr) ? priority(e.value) : 0;
+	}
+	if (priority != nullptr) {
+		std::make_heap(items.begin(), items.end(), takenAfter);
+	}
+	items.resize(slots.size());
+	slots = std::move(items);
+	head = 0;
+}
+
+// PostCondition: doubles capacity, items remain in order from position 0
+template <class T>
+void Mempool<T>::grow() {
+	std::vector<Entry> bigger(slots.size() * 2);
+	for (int i = 0; i < count; i++) {
+		bigger[i] = std::move(at(i));
+	}
+	slots = std::move(bigger);
+	head = 0;
+}
+
+// PostCondition: value added to pool with given priority key
+template <class T>
+void Mempool<T>::push(T && value, double key) {
+	if (count == static_cast<int>(slots.size())) {
+		grow();
+	}
+	Entry & e = at(count);
+	e.value = std::move(value);
+	e.key = key;
+	e.seq = nextSeq++;
+	count++;
+	if (priority != nullptr) {
+		std::push_heap(slots.begin(), slots.begin() + count, takenAfter);
+	}
+}
+
+// PostCondition: copy of value added to pool
+template <class T>
+void Mempool<T>::add(const T & value) {
+	T copy(value);
+	add(std::move(copy));
+}
+
+// PostCondition: value moved into pool
+template <class T>
+void Mempool<T>::add(T && value) {
+	double key = (priority != nullptr) ? priority(value) : 0;
+	push(std::move(value), key);
+}
+
+// PreCondition: pool is not empty
+// PostCondition: returns reference to next item to be taken
+template <class T>
+const T & Mempool<T>::front() const {
+	if (count == 0) {
+		throw std::underflow_error("Mempool: empty");
+	}
+	return at(0).value;
+}
+
+// PreCondition: pool is not empty
+// PostCondition: next item removed from pool and returned
+template <class T>
+T Mempool<T>::popFront() {
+	if (count == 0) {
+		throw std::underflow_error("Mempool: empty");
+	}
+	if (priority != nullptr) {
+		// move best item to end of heap
+		std::pop_heap(slots.begin(), slots.begin() + count, takenAfter);
+		count--;
+		return std::move(slots[count].value);
+	}
+	T value = std::move(at(0).value);
+	head = (head + 1) & (static_cast<int>(slots.size()) - 1);
+	count--;
+	return value;
+}
+
+// PostCondition: up to n items moved from pool to end of out, returns number moved
+template <class T>
+int Mempool<T>::takeBatch(int n, ArrayList<T> & out) {
+	int taken = 0;
+	for (; taken < n && count > 0; taken++) {
+		out.add(popFront());
+	}
+	return taken;
+}
+
+// PostCondition: pool emptied
+template <class T>
+void Mempool<T>::clear() {
+	for (int i = 0; i < count; i++) {
+		at(i).value = T();
+	}
+	head = 0;
+	count = 0;
+}
+
+// PostCondition: returns number of items in pool
+template <class T>
+int Mempool<T>::size() const {
+	return count;
+}
+
+// PostCondition: returns true if pool is empty
+template <class T>
+bool Mempool<T>::isEmpty() const {
+	return (count == 0);
+}
+
+// PostCondition: prints items in the order they will be taken
+template <class T>
+void Mempool<T>::print(std::ostream & os) const {
+	std::vector<const Entry *> order;
+	order.reserve(count);
+	for (int i = 0; i < count; i++) {
+		order.push_back(&at(i));
+	}
+	if (priority != nullptr) {
+		std::sort(order.begin(), order.end(), [](const Entry * a, const Entry * b) { return takenAfter(*b, *a); });
+	}
+	os << "[ ";
+	for (const Entry * e : order) {
+		os << e->value << " ";
+	}
+	os << "]";
+}
+
+// PreCondition: None
+// PostCondition: overload << operator to output Mempool on ostream
+template <class T>
+std::ostream& operator <<(std::ostream& output, const Mempool<T>& m) {
+	m.print(output);
+	return output;  // for multiple << operators.
+}
+
+#endif /* MEMPOOL_H */
@@ -0,0 +1,269 @@
+/**
+ * Miner.h
+ *
+ * Multithreaded proof of work engine
+ *
+ * Splits the nonce space across a pool of worker threads. Thread t of n
+ * tries nonces start+t, start+t+n, ... so the first (lowest) nonce found
+ * is always the one a single threaded search would have accepted.
+ *
+ * The nonce independent prefix of the hash input is compressed once and the
+ * SHA256 state snapshotted (midstate), so each attempt only hashes the tail.
+ * Attempts are tested on the raw digest bytes against a leading zero bit
+ * target, only the winning hash is converted to a hex string. Nonces are
+ * hashed in batches through the picosha2 multi-buffer (SIMD) kernel.
+ *
+ * The nonce is appended to the prefix either as decimal text (version 1
+ * blocks) or as 4 little endian bytes (version 2 blocks).
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef MINER_H
+#define MINER_H
+
+#include "picosha2.h"	// SHA256 hash algorithm
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ------------------ Statistics recorded by each mining thread -------------------
+struct MinerThreadStats {
+	long long hashes = 0;	// number of nonces tried
+	double seconds = 0;		// time spent searching
+
+	// PostCondition: returns hashes per second achieved by the thread
+	double hashRate() const {
+		return (seconds > 0) ? hashes / seconds : 0;
+	}
+};
+
+// ------------------ Result of a proof of work search ---------------------------
+struct MiningResult {
+	int nonce = 0;							// winning nonce
+	std::string hash;						// hex hash produced by winning nonce
+	std::vector<MinerThreadStats> threads;	// per thread statistics
+
+	// PostCondition: returns combined hashes per second of all threads
+	double hashRate() const {
+		double rate = 0;
+		for (const MinerThreadStats & s : threads) {
+			rate += s.hashRate();
+		}
+		return rate;
+	}
+};
+
+// ------------------ How the nonce is appended to the hash input ----------------
+enum class NonceEncoding {
+	Decimal,	// decimal digits, as std::to_string
+	Binary32	// 4 bytes, least significant first
+};
+
+// PostCondition: returns nonce encoded as the tail of the hash input
+inline std::string encodeNonce(int nonce, NonceEncoding encoding) {
+	if (encoding == NonceEncoding::Decimal) {
+		return std::to_string(nonce);
+	}
+	std::string tail(4, '\0');
+	unsigned int n = static_cast<unsigned int>(nonce);
+	for (int i = 0; i < 4; i++) {
+		tail[i] = static_cast<char>((n >> (8 * i)) & 0xff);
+	}
+	return tail;
+}
+
+// ------------------ Proof of work target -------------------------------------
+// A hash meets the target when it begins with at least zeroBits 0 bits, a
+// difficulty of n hex digits is equivalent to a target of 4n bits
+class DifficultyTarget {
+public:
+	// PreCondition:  bits >= 0 && bits <= 256
+	// PostCondition: target requiring bits leading zero bits
+	explicit DifficultyTarget(int bits = 0) : zeroBits{ validBits(bits) },
+		fullBytes{ zeroBits / 8 }, mask{ static_cast<picosha2::byte_t>(0xff00 >> (zeroBits % 8)) } {}
+
+	// PostCondition: returns target equivalent to hex string beginning with digits 0's
+	static DifficultyTarget fromHexDigits(int digits) {
+		return DifficultyTarget(digits * 4);
+	}
+
+	// PostCondition: returns number of leading zero bits required
+	int bits() const {
+		return zeroBits;
+	}
+
+	// PostCondition: returns true if the 32 byte digest meets the target
+	bool isMetBy(const picosha2::byte_t * digest) const {
+		for (int i = 0; i < fullBytes; i++) {
+			if (digest[i] != 0) {
+				return false;
+			}
+		}
+		return fullBytes == static_cast<int>(picosha2::k_digest_size) || (digest[fullBytes] & mask) == 0;
+	}
+
+private:
+	// PostCondition: returns bits, checked before any member is derived from it
+	static int validBits(int bits) {
+		if (bits < 0 || bits > 256) {
+			throw std::out_of_range("DifficultyTarget: invalid number of bits: " + std::to_string(bits));
+		}
+		return bits;
+	}
+
+	int zeroBits;			// leading zero bits required
+	int fullBytes;			// number of leading bytes that must be zero
+	picosha2::byte_t mask;	// bits of the following byte that must be zero
+};
+
+// ---------------- SHA256 hasher caching the state after a fixed prefix ----------
+// The full 64 byte blocks of the prefix are compressed once on construction,
+// each call to hash() restores that state and only processes the changing tail
+class MidstateHasher {
+public:
+	explicit MidstateHasher(const std::string & prefix) {
+		midstate.process(prefix.begin(), prefix.end());
+	}
+
+	// PostCondition: SHA256 digest of prefix + tail written to digest
+	void hash(const std::string & tail, picosha2::byte_t * digest) {
+		worker = midstate;	// copy assignment reuses the worker buffer
+		worker.process(tail.begin(), tail.end());
+		worker.finish();
+		worker.get_hash_bytes(digest, digest + picosha2::k_digest_size);
+	}
+
+	// PostCondition: SHA256 digest of prefix + tails[i] written to digests + 32 * i
+	//                for each of the n tails, hashed together in SIMD lanes
+	void hashBatch(const std::string * tails, std::size_t n, picosha2::byte_t * digests) const {
+		const picosha2::byte_t * data[picosha2::k_multi_lanes];
+		std::size_t lengths[picosha2::k_multi_lanes];
+		for (std::size_t i = 0; i < n; i++) {
+			data[i] = reinterpret_cast<const picosha2::byte_t *>(tails[i].data());
+			lengths[i] = tails[i].size();
+		}
+		midstate.finish_multi(data, lengths, n, digests);
+	}
+
+	// PostCondition: returns hex string SHA256 hash of prefix + tail
+	std::string hexHash(const std::string & tail) {
+		picosha2::byte_t digest[picosha2::k_digest_size];
+		hash(tail, digest);
+		return picosha2::bytes_to_hex_string(digest, digest + picosha2::k_digest_size);
+	}
+
+private:
+	picosha2::hash256_one_by_one midstate;	// state after the prefix
+	picosha2::hash256_one_by_one worker;	// state used for each attempt
+};
+
+// ------------------------- The ParallelMiner Class ----------------------------
+class ParallelMiner {
+public:
+	// PostCondition: miner using numThreads workers (0 selects one per hardware thread)
+	explicit ParallelMiner(int numThreads = 1) {
+		setThreads(numThreads);
+	}
+
+	// PostCondition: number of worker threads updated (0 selects one per hardware thread)
+	void setThreads(int n) {
+		if (n <= 0) {
+			n = static_cast<int>(std::thread::hardware_concurrency());
+		}
+		numThreads = (n > 0) ? n : 1;
+	}
+
+	// PostCondition: returns number of worker threads
+	int threads() const {
+		return numThreads;
+	}
+
+	// PreCondition:  difficulty >= 0
+	// PostCondition: returns lowest nonce >= startNonce whose hash of prefix + nonce
+	//                begins with difficulty 0's
+	MiningResult mine(const std::string & prefix, int difficulty, int startNonce = 0,
+		NonceEncoding encoding = NonceEncoding::Decimal) const {
+		return mine(prefix, DifficultyTarget::fromHexDigits(difficulty), startNonce, encoding);
+	}
+
+	// PostCondition: returns lowest nonce >= startNonce whose hash of prefix + nonce
+	//                (appended using encoding) meets target
+	MiningResult mine(const std::string & prefix, const DifficultyTarget & target, int startNonce = 0,
+		NonceEncoding encoding = NonceEncoding::Decimal) const {
+		MiningResult result;
+		result.threads.resize(numThreads);
+		std::atomic<int> best{ INT_MAX };
+		MidstateHasher hasher(prefix);	// prefix compressed once, copied to each thread
+
+		if (numThreads == 1) {
+			search(hasher, target, encoding, startNonce, 1, best, result.threads[0]);
+		}
+		else {
+			std::vector<std::thread> workers;
+			for (int t = 0; t < numThreads; t++) {
+				workers.emplace_back(&ParallelMiner::search, hasher, target, encoding,
+					startNonce + t, numThreads, std::ref(best), std::ref(result.threads[t]));
+			}
+			for (std::thread & w : workers) {
+				w.join();
+			}
+		}
+
+		if (best.load() == INT_MAX) {
+			throw std::runtime_error("ParallelMiner: nonce space exhausted");
+		}
+		result.nonce = best.load();
+		result.hash = hasher.hexHash(encodeNonce(result.nonce, encoding));
+		return result;
+	}
+
+private:
+	int numThreads;
+
+	// PostCondition: tries nonces first, first+step, ... until one meets target or
+	//                a lower winning nonce has been published in best
+	static void search(MidstateHasher hasher, DifficultyTarget target, NonceEncoding encoding, int first, int step,
+		std::atomic<int> & best, MinerThreadStats & stats) {
+		auto start = std::chrono::steady_clock::now();
+		const int lanes = static_cast<int>(picosha2::k_multi_lanes);
+		std::string tails[picosha2::k_multi_lanes];
+		picosha2::byte_t digests[picosha2::k_multi_lanes * picosha2::k_digest_size];
+
+		for (int nonce = first; nonce < best.load(std::memory_order_relaxed); ) {
+			// hash the next batch of this thread's nonces together
+			int batch = 0;
+			for (; batch < lanes && nonce <= INT_MAX - batch * step; batch++) {
+				tails[batch] = encodeNonce(nonce + batch * step, encoding);
+			}
+			hasher.hashBatch(tails, batch, digests);
+			stats.hashes += batch;
+
+			// lowest nonce of the batch meeting the target wins
+			for (int i = 0; i < batch; i++) {
+				if (target.isMetBy(digests + i * picosha2::k_digest_size)) {
+					// publish nonce if it is lower than any already found
+					int found = nonce + i * step;
+					int current = best.load();
+					while (found < current && !best.compare_exchange_weak(current, found)) {}
+					batch = -1;
+					break;
+				}
+			}
+			if (batch < 0 || nonce > INT_MAX - batch * step) {
+				break;	// nonce found or no nonces left for this thread
+			}
+			nonce += batch * step;
+		}
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+#endif /* MINER_H */
@@ -0,0 +1,308 @@
+/**
+ * SegmentedList.h
+ *
+ * Generic random access list stored in a directory of contiguous segments.
+ * Each segment is twice the size of the previous one, so growing the list
+ * never moves existing elements and references to them remain valid.
+ * The size is published after each element is constructed, so any number of
+ * reader threads may access elements below size() while one thread appends.
+ *
+ * @author  agent
+ * @email   agent@local
+ * @version 1.0
+ */
+
+#ifndef SEGMENTEDLIST_H
+#define SEGMENTEDLIST_H
+
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#if defined(_MSC_VER)
+#include <intrin.h>	// _BitScanReverse
+#endif
+
+template <class T> class SegmentedList;
+
+// ============================= SEGMENTED LIST ITERATOR ===================================
+
+// Iterator used to traverse a SegmentedList without copying elements, steps
+// through each segment by pointer and only recalculates at segment boundaries
+template <class T>
+class SegmentedIterator {
+	public:
+		SegmentedIterator(const SegmentedList<T> *list = nullptr, int pos = 0) : list(list), pos(pos),
+			current(nullptr), segmentEnd(nullptr) { locate(); }
+		const T & operator*() const							{ return *current; }
+		const T * operator->() const						{ return current; }
+		SegmentedIterator & operator++()					{ ++pos; if (++current == segmentEnd) { locate(); } return *(this); }
+		SegmentedIterator operator++(int)					{ SegmentedIterator tmp(*this); ++(*this); return tmp; }
+		SegmentedIterator operator+(int n) const			{ return SegmentedIterator(list, pos + n); }
+		int index() const									{ return pos; }
+
+		bool operator!=(const SegmentedIterator & o) const	{ return pos != o.pos; }
+		bool operator==(const SegmentedIterator & o) const	{ return pos == o.pos; }
+	private:
+		// PostCondition: current and segmentEnd refer to the segment containing pos
+		void locate() {
+			if (list != nullptr && pos < list->size()) {
+				current = &list->at(pos);
+				segmentEnd = current + list->remainingInSegment(pos);
+			}
+		}
+
+		const SegmentedList<T> *list;
+		int pos;
+		const T *current;
+		const T *segmentEnd;
+};
+
+// ============================== SEGMENTED LIST ===========================================
+template <class T>
+class SegmentedList {
+public:
+	SegmentedList();
+	~SegmentedList();
+	SegmentedList(const SegmentedList<T> & other);
+	SegmentedList(SegmentedList<T> && other) noexcept;
+	SegmentedList<T> & operator=(const SegmentedList<T> & other);
+	SegmentedList<T> & operator=(SegmentedList<T> && other) noexcept;
+
+	void clear();
+	void add(const T & value);
+	void add(T && value);
+	template <class... Args> void emplace(Args&&... args);
+	void set(int pos, const T & value);
+	const T & get(int pos) const;
+	const T & back() const;
+	int  size() const;
+	bool isEmpty() const;
+
+	void print(std::ostream & os) const;
+
+	// PreCondition: pos is a valid list position (not checked)
+	// PostCondition: returns reference to element at pos
+	const T & at(int pos) const		{ return segments[segmentOf(pos)][offsetOf(pos)]; }
+	T & at(int pos)					{ return segments[segmentOf(pos)][offsetOf(pos)]; }
+
+	// Iterators
+	SegmentedIterator<T> begin() const	{ return SegmentedIterator<T>(this, 0); }
+	SegmentedIterator<T> end() const	{ return SegmentedIterator<T>(this, size()); }
+
+	// PostCondition: returns number of elements from pos to the end of its segment
+	int remainingInSegment(int pos) const	{ return segmentSize(segmentOf(pos)) - offsetOf(pos); }
+
+private:
+	const static int FIRSTSEGMENTBITS = 4;					// first segment holds 16 elements
+	const static int MAXSEGMENTS = 32 - FIRSTSEGMENTBITS;	// enough segments for any int position
+
+	static int segmentOf(int pos);
+	static int offsetOf(int pos);
+	static int segmentSize(int seg)	{ return 1 << (seg + FIRSTSEGMENTBITS); }
+	T *slot(int pos);
+	void steal(SegmentedList<T> & other);
+
+	T *segments[MAXSEGMENTS];	// segment k holds 2^(k+FIRSTSEGMENTBITS) elements
+	std::atomic<int> count;		// published with release once an appended element is constructed
+};
+
+// ============================== SegmentedList Implementation ======================
+
+// Default Constructor
+template <class T>
+SegmentedList<T>::SegmentedList() : count{ 0 } {
+	for (int i = 0; i < MAXSEGMENTS; i++) {
+		segments[i] = nullptr;
+	}
+}
+
+// Destructor
+template <class T>
+SegmentedList<T>::~SegmentedList() {
+	clear();
+}
+
+// PostCondition: construct SegmentedList as a duplicate of other
+template <class T>
+SegmentedList<T>::SegmentedList(const SegmentedList<T> & other) : SegmentedList() {
+	for (int i = 0; i < other.size(); i++) {
+		add(other.at(i));
+	}
+}
+
+// PostCondition: assign other to SegmentedList
+template <class T>
+SegmentedList<T> & SegmentedList<T>::operator=(const SegmentedList<T> & other) {
+	if (this != &other) {
+		clear();
+		for (int i = 0; i < other.size(); i++) {
+			add(other.at(i));
+		}
+	}
+	return *this;
+}
+
+// PostCondition: construct SegmentedList by taking over the segments of other, other is left empty
+template <class T>
+SegmentedList<T>::SegmentedList(SegmentedList<T> && other) noexcept : SegmentedList() {
+	steal(other);
+}
+
+// PostCondition: segments of other moved into SegmentedList, other is left empty
+template <class T>
+SegmentedList<T> & SegmentedList<T>::operator=(SegmentedList<T> && other) noexcept {
+	if (this != &other) {
+		clear();
+		steal(other);
+	}
+	return *this;
+}
+
+// PreCondition: SegmentedList is empty
+// PostCondition: segments of other transferred to this, other is left empty
+template <class T>
+void SegmentedList<T>::steal(SegmentedList<T> & other) {
+	for (int i = 0; i < MAXSEGMENTS; i++) {
+		segments[i] = other.segments[i];
+		other.segments[i] = nullptr;
+	}
+	count.store(other.count.load());
+	other.count.store(0);
+}
+
+// PostCondition: returns segment containing element at pos
+template <class T>
+int SegmentedList<T>::segmentOf(int pos) {
+	unsigned int p = (static_cast<unsigned int>(pos) >> FIRSTSEGMENTBITS) + 1;
+#if defined(__GNUC__)
+	return 31 - __builtin_clz(p);			// index of highest set bit
+#elif defined(_MSC_VER)
+	unsigned long seg;
+	_BitScanReverse(&seg, p);
+	return static_cast<int>(seg);
+#else
+	int seg = 0;
+	while (p >>= 1) {
+		seg++;
+	}
+	return seg;
+#endif
+}
+
+// PostCondition: returns offset of element at pos within its segment
+template <class T>
+int SegmentedList<T>::offsetOf(int pos) {
+	return pos + (1 << FIRSTSEGMENTBITS) - segmentSize(segmentOf(pos));
+}
+
+// PostCondition: returns uninitialised storage for element at pos, allocating its segment if required
+template <class T>
+T * SegmentedList<T>::slot(int pos) {
+	int seg = segmentOf(pos);
+	if (segments[seg] == nullptr) {
+		// allocate uninitialised storage for the new segment
+		segments[seg] = static_cast<T *>(::operator new(sizeof(T) * segmentSize(seg)));
+	}
+	return &segments[seg][offsetOf(pos)];
+}
+
+// PostCondition: value added to end of SegmentedList, existing elements are not moved
+template <class T>
+void SegmentedList<T>::add(const T & value) {
+	int n = count.load(std::memory_order_relaxed);
+	new (slot(n)) T(value);
+	count.store(n + 1, std::memory_order_release);
+}
+
+// PostCondition: value moved to end of SegmentedList, existing elements are not moved
+template <class T>
+void SegmentedList<T>::add(T && value) {
+	int n = count.load(std::memory_order_relaxed);
+	new (slot(n)) T(std::move(value));
+	count.store(n + 1, std::memory_order_release);
+}
+
+// PostCondition: element constructed in place from args at end of SegmentedList
+template <class T>
+template <class... Args>
+void SegmentedList<T>::emplace(Args&&... args) {
+	int n = count.load(std::memory_order_relaxed);
+	new (slot(n)) T(std::forward<Args>(args)...);
+	count.store(n + 1, std::memory_order_release);
+}
+
+// PreCondition: pos is a valid SegmentedList position
+// PostCondition: updates element at specified position in SegmentedList
+template <class T>
+void SegmentedList<T>::set(int pos, const T & value) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("SegmentedList: invalid position: " + std::to_string(pos));
+	}
+	at(pos) = value;
+}
+
+// PreCondition: pos is a valid SegmentedList position
+// PostCondition: returns reference to element at specified position in SegmentedList
+template <class T>
+const T & SegmentedList<T>::get(int pos) const {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("SegmentedList: invalid position: " + std::to_string(pos));
+	}
+	return at(pos);
+}
+
+// PreCondition: SegmentedList is not empty
+// PostCondition: returns reference to last element in SegmentedList
+template <class T>
+const T & SegmentedList<T>::back() const {
+	return get(size() - 1);
+}
+
+// PostCondition: return number of elements in SegmentedList
+template <class T>
+int SegmentedList<T>::size() const {
+	return count.load(std::memory_order_acquire);
+}
+
+// PostCondition: returns true if SegmentedList is empty
+template <class T>
+bool SegmentedList<T>::isEmpty() const {
+	return (size() == 0);
+}
+
+// PostCondition: SegmentedList is emptied and all segments released count == 0;
+template <class T>
+void SegmentedList<T>::clear() {
+	for (int i = 0, n = size(); i < n; i++) {
+		at(i).~T();
+	}
+	for (int i = 0; i < MAXSEGMENTS; i++) {
+		::operator delete(segments[i]);
+		segments[i] = nullptr;
+	}
+	count.store(0);
+}
+
+// PostCondition: prints contents of SegmentedList to ostream
+template <class T>
+void SegmentedList<T>::print(std::ostream & os) const {
+	os << "[ ";
+	for (SegmentedIterator<T> itr = begin(); itr != end(); ++itr) {
+		os << (*itr) << " ";
+	}
+	os << "]";
+}
+
+// PreCondition: None
+// PostCondition: overload << operator to output SegmentedList on ostream
+template <class T>
+std::ostream& operator <<(std::ostream& output, const SegmentedList<T>& l) {
+	l.print(output);
+	return output;  // for multiple << operators.
+}
+
+#endif /* SEGMENTEDLIST_H */
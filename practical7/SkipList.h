@@ -0,0 +1,415 @@
+/***********************************************************************
+ * Name        : SkipList.h
+ * Author      : agent@local
+ * Version     : 1.0
+ * Description : Indexable Skip List with the same interface as LinkedList.
+ *               Nodes extend the LinkedList Node with extra forward links,
+ *               each recording how many positions it spans, so positional
+ *               get, set, add and remove are O(log n) while the bottom level
+ *               is an ordinary Node chain traversed with a ListIterator.
+ ***********************************************************************/
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include "LinkedList.h"
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// =============================== SKIP LIST NODE ==========================================
+// Node with height levels, level 0 is the Node next pointer (span always 1) and
+// levels 1..height-1 are held in upper
+template <class T>
+struct SkipNode : public Node<T> {
+	struct Link {
+		SkipNode<T>* next;	// next node at this level
+		int span;			// positions moved by following next
+	};
+
+	template <class... Args>
+	SkipNode(int height, Args&&... args) : Node<T>(std::in_place, std::forward<Args>(args)...), height(height),
+		upper(newLinks(height)) {}
+	~SkipNode() { delete[] upper; }
+	SkipNode(const SkipNode<T> &) = delete;
+	SkipNode<T> & operator=(const SkipNode<T> &) = delete;
+
+	SkipNode<T>* nextAt(int level) const	{ return (level == 0) ? static_cast<SkipNode<T>*>(this->next) : upper[level - 1].next; }
+	int spanAt(int level) const				{ return (level == 0) ? 1 : upper[level - 1].span; }
+	void link(int level, SkipNode<T>* n, int span) {
+		if (level == 0) { this->next = n; }
+		else { upper[level - 1].next = n; upper[level - 1].span = span; }
+	}
+
+	int height;
+	Link* upper;
+
+private:
+	static Link* newLinks(int height) {
+		Link* links = (height > 1) ? new Link[height - 1] : nullptr;
+		for (int i = 0; i < height - 1; i++) {
+			links[i].next = nullptr;
+			links[i].span = 0;
+		}
+		return links;
+	}
+};
+
+// ============================== SKIP LIST ================================================
+template <class T>
+class SkipList {
+public:
+	SkipList();
+	virtual ~SkipList();
+	SkipList(const SkipList<T> & other);
+	SkipList(SkipList<T> && other);
+	SkipList<T> & operator=(const SkipList<T> & other);
+	SkipList<T> & operator=(SkipList<T> && other) noexcept;
+	bool operator==(const SkipList<T> & other) const;
+
+	void clear();
+	void add(const T & value);
+	void add(T && value);
+	void add(int pos, const T & value);
+	void add(int pos, T && value);
+	template <class... Args> void emplace(Args&&... args);
+	void remove(int pos);
+	void set(int pos, const T & value);
+	T    get(int pos) const;
+	int  size() const;
+	bool isEmpty() const;
+
+	void print(std::ostream & os) const;
+	int  find(const T & value) const;
+
+	// Iterators
+	ListIterator<T> begin() const	{ return ListIterator<T>(header->next); }
+	ListIterator<T> end() const		{ return ListIterator<T>(nullptr); }
+
+private:
+	const static int MAXLEVEL = 32;		// enough levels for any int position
+
+	SkipNode<T>* nodeAt(int pos) const;
+	template <class... Args> void insert(int pos, Args&&... args);
+	int randomHeight();
+	void swap(SkipList<T> & other);
+
+	SkipNode<T> *header, *tail;	// dummy header node of height MAXLEVEL and last node
+	int count;
+	int levels;					// number of levels in use
+	unsigned int seed;			// state of node height generator
+};
+
+// ============================== SkipList Implementation ======================
+
+// Default Constructor
+template <class T>
+SkipList<T>::SkipList() : header{ new SkipNode<T>(MAXLEVEL) }, count{ 0 }, levels{ 1 }, seed{ 2463534242u } {
+	tail = header;			// TAIL POINTS TO HEADER
+}
+
+// Destructor
+template <class T>
+SkipList<T>::~SkipList() {
+	clear();
+	delete header;
+}
+
+// PostCondition: construct SkipList as a duplicate of other
+template <class T>
+SkipList<T>::SkipList(const SkipList<T> & other) : SkipList() {
+	for (ListIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+		add(*itr);
+	}
+}
+
+// PostCondition: construct SkipList by taking over the nodes of other, other is left empty
+//                (not noexcept as other is given a new header node)
+template <class T>
+SkipList<T>::SkipList(SkipList<T> && other) : SkipList() {
+	swap(other);
+}
+
+// PostCondition: assign other to SkipList
+template <class T>
+SkipList<T> & SkipList<T>::operator=(const SkipList<T> & other) {
+	if (this != &other) {
+		clear();
+		for (ListIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+			add(*itr);
+		}
+	}
+	return *this;
+}
+
+// PostCondition: nodes of other moved into SkipList, other is left empty
+template <class T>
+SkipList<T> & SkipList<T>::operator=(SkipList<T> && other) noexcept {
+	if (this != &other) {
+		clear();
+		swap(other);
+	}
+	return *this;
+}
+
+// PostCondition: nodes of this and other exchanged
+template <class T>
+void SkipList<T>::swap(SkipList<T> & other) {
+	std::swap(header, other.header);
+	std::swap(tail, other.tail);
+	std::swap(count, other.count);
+	std::swap(levels, other.levels);
+	std::swap(seed, other.seed);
+}
+
+// PostCondition: test SkipLists for equality
+template <class T>
+bool SkipList<T>::operator==(const SkipList<T> & other) const {
+	if (size() != other.size()) {
+		return false;
+	}
+	for (ListIterator<T> itr = begin(), oitr = other.begin(); itr != end(); ++itr, ++oitr) {
+		if ((*itr) != (*oitr)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// PostCondition: return number of elements in SkipList
+template <class T>
+int SkipList<T>::size() const {
+	return count;
+}
+
+// PostCondition: returns true if SkipList is empty
+template <class T>
+bool SkipList<T>::isEmpty() const {
+	return (count == 0);
+}
+
+// PostCondition: returns height for a new node, each extra level with probability 1/4
+template <class T>
+int SkipList<T>::randomHeight() {
+	int height = 1;
+	for (;;) {
+		// xorshift32
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		for (unsigned int bits = seed; height < MAXLEVEL && bits != 0; bits >>= 2) {
+			if ((bits & 3) != 0) {
+				return height;
+			}
+			height++;
+		}
+		if (height == MAXLEVEL) {
+			return height;
+		}
+	}
+}
+
+// PreCondition:  pos >= -1 && pos < count (-1 is the header)
+// PostCondition: returns reference to Node at specified position
+template <class T>
+SkipNode<T>* SkipList<T>::nodeAt(int pos) const {
+	if (pos == count - 1) {	// LAST NODE SO RETURN tail
+		return tail;
+	}
+	SkipNode<T>* x = header;
+	int rank = -1;			// position of x
+	for (int level = levels - 1; level >= 0; level--) {
+		while (x->nextAt(level) != nullptr && rank + x->spanAt(level) <= pos) {
+			rank += x->spanAt(level);
+			x = x->nextAt(level);
+		}
+		if (rank == pos) {
+			break;
+		}
+	}
+	return x;
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: element constructed from args inserted at pos, spans of the links
+//                passing over pos updated
+template <class T>
+template <class... Args>
+void SkipList<T>::insert(int pos, Args&&... args) {
+	if (pos < 0 || pos > size()) {
+		throw std::out_of_range("SkipList invalid position: " + std::to_string(pos));
+	}
+	SkipNode<T>* update[MAXLEVEL] = {};	// last node before pos at each level
+	int rank[MAXLEVEL] = {};			// position of update[level]
+	SkipNode<T>* x = header;
+	int r = -1;
+	for (int level = levels - 1; level >= 0; level--) {
+		while (x->nextAt(level) != nullptr && r + x->spanAt(level) < pos) {
+			r += x->spanAt(level);
+			x = x->nextAt(level);
+		}
+		update[level] = x;
+		rank[level] = r;
+	}
+
+	int height = randomHeight();
+	for (; levels < height; levels++) {
+		update[levels] = header;
+		rank[levels] = -1;
+		header->link(levels, nullptr, count + 1);
+	}
+
+	SkipNode<T>* n = new SkipNode<T>(height, std::forward<Args>(args)...);
+	for (int level = 0; level < height; level++) {
+		SkipNode<T>* prev = update[level];
+		int before = pos - rank[level];		// distance from prev to n
+		n->link(level, prev->nextAt(level), prev->spanAt(level) - before + 1);
+		prev->link(level, n, before);
+	}
+	for (int level = height; level < levels; level++) {
+		update[level]->link(level, update[level]->nextAt(level), update[level]->spanAt(level) + 1);
+	}
+	if (pos == count) { tail = n; }			// INSERTED AT END SO UPDATE TAIL
+	count++;
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: inserts element value at specified position
+template <class T>
+void SkipList<T>::add(int pos, const T & value) {
+	insert(pos, value);
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: moves value into specified position
+template <class T>
+void SkipList<T>::add(int pos, T && value) {
+	insert(pos, std::move(value));
+}
+
+// PostCondition: inserts element value at end of SkipList
+template <class T>
+void SkipList<T>::add(const T & value) {
+	insert(count, value);
+}
+
+// PostCondition: moves value to end of SkipList
+template <class T>
+void SkipList<T>::add(T && value) {
+	insert(count, std::move(value));
+}
+
+// PostCondition: element constructed from args added to end of SkipList
+template <class T>
+template <class... Args>
+void SkipList<T>::emplace(Args&&... args) {
+	insert(count, std::forward<Args>(args)...);
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: deletes node at specified position, links passing over it shortened
+template <class T>
+void SkipList<T>::remove(int pos) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("SkipList invalid position: " + std::to_string(pos));
+	}
+	SkipNode<T>* x = header;
+	int r = -1;
+	SkipNode<T>* update[MAXLEVEL] = {};
+	for (int level = levels - 1; level >= 0; level--) {
+		while (x->nextAt(level) != nullptr && r + x->spanAt(level) < pos) {
+			r += x->spanAt(level);
+			x = x->nextAt(level);
+		}
+		update[level] = x;
+	}
+
+	SkipNode<T>* curr = update[0]->nextAt(0);	// node being deleted
+	for (int level = 0; level < levels; level++) {
+		SkipNode<T>* prev = update[level];
+		if (prev->nextAt(level) == curr) {
+			prev->link(level, curr->nextAt(level), prev->spanAt(level) + curr->spanAt(level) - 1);
+		}
+		else {
+			prev->link(level, prev->nextAt(level), prev->spanAt(level) - 1);
+		}
+	}
+	while (levels > 1 && header->nextAt(levels - 1) == nullptr) {
+		levels--;
+	}
+	if (pos == count - 1) { tail = update[0]; }	// IF LAST NODE DELETED UPDATE TAIL
+	count--;
+	delete curr;
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: returns copy of element at pos
+template <class T>
+T SkipList<T>::get(int pos) const {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("SkipList invalid position: " + std::to_string(pos));
+	}
+	return nodeAt(pos)->data;
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: updates element at specified position
+template <class T>
+void SkipList<T>::set(int pos, const T & value) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("SkipList invalid position: " + std::to_string(pos));
+	}
+	nodeAt(pos)->data = value;
+}
+
+// PostCondition: returns index of item if found or -1 if not found
+template <class T>
+int SkipList<T>::find(const T & value) const {
+	int i = 0;
+	for (ListIterator<T> itr = begin(); itr != end(); itr++, i++) {
+		if ((*itr) == value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// PostCondition: SkipList is emptied count == 0;
+template <class T>
+void SkipList<T>::clear() {
+	SkipNode<T>* p = header->nextAt(0);
+	while (p != nullptr) {
+		SkipNode<T>* n = p->nextAt(0);
+		delete p;
+		p = n;
+	}
+	for (int level = 0; level < MAXLEVEL; level++) {
+		header->link(level, nullptr, 0);
+	}
+	tail = header;
+	count = 0;
+	levels = 1;
+}
+
+// PostCondition: prints contents of SkipList to ostream
+template <class T>
+void SkipList<T>::print(std::ostream & os) const {
+	os << "[ ";
+	for (ListIterator<T> itr = begin(); itr != end(); ++itr) {
+		os << (*itr) << " ";
+	}
+	os << "]";
+}
+
+// PreCondition: None
+// PostCondition: overload << operator to output SkipList on ostream
+template <class T>
+std::ostream& operator <<(std::ostream& output, const SkipList<T>& l) {
+	l.print(output);
+	return output;  // for multiple << operators.
+}
+
+#endif /* SKIPLIST_H */
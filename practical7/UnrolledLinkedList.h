@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Name        : UnrolledLinkedList.h
+ * Author      : agent@local
+ * Version     : 1.0
+ * Description : Unrolled (chunked) Linked List with the same interface as
+ *               LinkedList. Each node holds a small array of elements sized
+ *               to a multiple of a cache line, so traversal touches far fewer
+ *               nodes and positional access skips whole chunks.
+ ***********************************************************************/
+
+#ifndef UNROLLEDLINKEDLIST_H
+#define UNROLLEDLINKEDLIST_H
+
+#include <iostream>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// =============================== UNROLLED NODE ===========================================
+// Chunk of up to CAPACITY elements, only the first used elements are constructed
+template <class T>
+struct UnrolledNode {
+	const static int CACHELINE = 64;
+	const static int CAPACITY = (4 * CACHELINE / static_cast<int>(sizeof(T)) > 4) ? 4 * CACHELINE / static_cast<int>(sizeof(T)) : 4;
+
+	UnrolledNode(UnrolledNode<T>* n = nullptr) : next(n), used(0) {}
+
+	T* items()				{ return reinterpret_cast<T*>(storage); }
+	const T* items() const	{ return reinterpret_cast<const T*>(storage); }
+
+	UnrolledNode<T>* next;
+	int used;
+	alignas(T) unsigned char storage[sizeof(T) * CAPACITY];
+};
+
+// ============================= UNROLLED LIST ITERATOR ====================================
+template <class T>
+class UnrolledIterator {
+	public:
+		UnrolledIterator(UnrolledNode<T> *start = nullptr) : node(start), index(0) {}
+		T & operator*()											{ return node->items()[index]; }
+		UnrolledIterator & operator++()							{ if (++index == node->used) { node = node->next; index = 0; } return *(this); }
+		UnrolledIterator operator++(int)						{ UnrolledIterator tmp(*this); ++(*this); return tmp; }
+
+		bool operator!=(const UnrolledIterator & o) const		{ return node != o.node || index != o.index; }
+		bool operator==(const UnrolledIterator & o) const		{ return !(*this != o); }
+	private:
+		UnrolledNode<T> *node;
+		int index;
+};
+
+// ============================== UNROLLED LINKED LIST =====================================
+template <class T>
+class UnrolledLinkedList {
+public:
+	UnrolledLinkedList();
+	virtual ~UnrolledLinkedList();
+	UnrolledLinkedList(const UnrolledLinkedList<T> & other);
+	UnrolledLinkedList(UnrolledLinkedList<T> && other);
+	UnrolledLinkedList<T> & operator=(const UnrolledLinkedList<T> & other);
+	UnrolledLinkedList<T> & operator=(UnrolledLinkedList<T> && other) noexcept;
+	bool operator==(const UnrolledLinkedList<T> & other) const;
+
+	void clear();
+	void add(const T & value);
+	void add(T && value);
+	void add(int pos, const T & value);
+	void add(int pos, T && value);
+	template <class... Args> void emplace(Args&&... args);
+	void remove(int pos);
+	void set(int pos, const T & value);
+	T    get(int pos) const;
+	int  size() const;
+	bool isEmpty() const;
+
+	void print(std::ostream & os) const;
+	int  find(const T & value) const;
+
+	// Iterators
+	UnrolledIterator<T> begin() const	{ return UnrolledIterator<T>(header->next); }
+	UnrolledIterator<T> end() const		{ return UnrolledIterator<T>(nullptr); }
+
+private:
+	typedef UnrolledNode<T> Chunk;
+
+	Chunk* chunkAt(int & pos) const;
+	template <class... Args> void insert(int pos, Args&&... args);
+	void swap(UnrolledLinkedList<T> & other);
+
+	Chunk *header, *tail;	// dummy header chunk (never holds elements) and last chunk
+	int count;
+};
+
+// ============================== UnrolledLinkedList Implementation ======================
+
+// Default Constructor
+template <class T>
+UnrolledLinkedList<T>::UnrolledLinkedList() : header{ new Chunk() }, count{ 0 } {
+	tail = header;			// TAIL POINTS TO HEADER
+}
+
+// Destructor
+template <class T>
+UnrolledLinkedList<T>::~UnrolledLinkedList() {
+	clear();
+	delete header;
+}
+
+// PostCondition: construct UnrolledLinkedList as a duplicate of other
+template <class T>
+UnrolledLinkedList<T>::UnrolledLinkedList(const UnrolledLinkedList<T> & other) : UnrolledLinkedList() {
+	for (UnrolledIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+		add(*itr);
+	}
+}
+
+// PostCondition: construct UnrolledLinkedList by taking over the chunks of other, other is left empty
+// (not noexcept as other is given a new header chunk)
+template <class T>
+UnrolledLinkedList<T>::UnrolledLinkedList(UnrolledLinkedList<T> && other) : UnrolledLinkedList() {
+	swap(other);
+}
+
+// PostCondition: assign other to UnrolledLinkedList
+template <class T>
+UnrolledLinkedList<T> & UnrolledLinkedList<T>::operator=(const UnrolledLinkedList<T> & other) {
+	if (this != &other) {
+		clear();
+		for (UnrolledIterator<T> itr = other.begin(); itr != other.end(); ++itr) {
+			add(*itr);
+		}
+	}
+	return *this;
+}
+
+// PostCondition: chunks of other moved into UnrolledLinkedList, other is left empty
+template <class T>
+UnrolledLinkedList<T> & UnrolledLinkedList<T>::operator=(UnrolledLinkedList<T> && other) noexcept {
+	if (this != &other) {
+		clear();
+		swap(other);
+	}
+	return *this;
+}
+
+// PostCondition: chunks of this and other exchanged
+template <class T>
+void UnrolledLinkedList<T>::swap(UnrolledLinkedList<T> & other) {
+	std::swap(header, other.header);
+	std::swap(tail, other.tail);
+	std::swap(count, other.count);
+}
+
+// PostCondition: test UnrolledLinkedLists for equality
+template <class T>
+bool UnrolledLinkedList<T>::operator==(const UnrolledLinkedList<T> & other) const {
+	if (size() != other.size()) {
+		return false;
+	}
+	for (UnrolledIterator<T> itr = begin(), oitr = other.begin(); itr != end(); ++itr, ++oitr) {
+		if ((*itr) != (*oitr)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// PostCondition: return number of elements in UnrolledLinkedList
+template <class T>
+int UnrolledLinkedList<T>::size() const {
+	return count;
+}
+
+// PostCondition: returns true if UnrolledLinkedList is empty
+template <class T>
+bool UnrolledLinkedList<T>::isEmpty() const {
+	return (count == 0);
+}
+
+// PreCondition:  pos is a valid element position
+// PostCondition: returns chunk containing element pos, pos updated to position within chunk
+template <class T>
+typename UnrolledLinkedList<T>::Chunk* UnrolledLinkedList<T>::chunkAt(int & pos) const {
+	if (pos >= count - tail->used) {	// IN LAST CHUNK SO USE tail
+		pos -= count - tail->used;
+		return tail;
+	}
+	Chunk* c = header->next;
+	while (pos >= c->used) {			// skip whole chunks
+		pos -= c->used;
+		c = c->next;
+	}
+	return c;
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: element constructed from args inserted at pos (in place when it
+//                follows the last element of its chunk), a full chunk is split in two first
+template <class T>
+template <class... Args>
+void UnrolledLinkedList<T>::insert(int pos, Args&&... args) {
+	if (pos < 0 || pos > size()) {
+		throw std::out_of_range("UnrolledLinkedList invalid position: " + std::to_string(pos));
+	}
+	Chunk* c;
+	if (pos == count) {					// APPEND TO LAST CHUNK
+		c = tail;
+		pos = tail->used;
+		if (c == header || c->used == Chunk::CAPACITY) {
+			c = new Chunk();
+			tail->next = c;
+			tail = c;
+			pos = 0;
+		}
+	}
+	else {
+		c = chunkAt(pos);
+		if (c->used == Chunk::CAPACITY) {
+			// split: move upper half to a new chunk following c
+			Chunk* n = new Chunk(c->next);
+			int half = Chunk::CAPACITY / 2;
+			for (int i = half; i < c->used; i++) {
+				new (&n->items()[i - half]) T(std::move(c->items()[i]));
+				c->items()[i].~T();
+			}
+			n->used = c->used - half;
+			c->used = half;
+			c->next = n;
+			if (tail == c) { tail = n; }
+			if (pos > half) {
+				c = n;
+				pos -= half;
+			}
+		}
+	}
+
+	// make room within chunk then construct value
+	T* items = c->items();
+	if (pos < c->used) {
+		new (&items[c->used]) T(std::move(items[c->used - 1]));
+		for (int i = c->used - 1; i > pos; i--) {
+			items[i] = std::move(items[i - 1]);
+		}
+		items[pos] = T(std::forward<Args>(args)...);
+	}
+	else {
+		new (&items[pos]) T(std::forward<Args>(args)...);
+	}
+	c->used++;
+	count++;
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: inserts element value at specified position
+template <class T>
+void UnrolledLinkedList<T>::add(int pos, const T & value) {
+	insert(pos, value);
+}
+
+// PreCondition: pos is a valid insertion position
+// PostCondition: moves value into specified position
+template <class T>
+void UnrolledLinkedList<T>::add(int pos, T && value) {
+	insert(pos, std::move(value));
+}
+
+// PostCondition: inserts element value at end of UnrolledLinkedList
+template <class T>
+void UnrolledLinkedList<T>::add(const T & value) {
+	insert(count, value);
+}
+
+// PostCondition: moves value to end of UnrolledLinkedList
+template <class T>
+void UnrolledLinkedList<T>::add(T && value) {
+	insert(count, std::move(value));
+}
+
+// PostCondition: element constructed from args added to end of UnrolledLinkedList
+template <class T>
+template <class... Args>
+void UnrolledLinkedList<T>::emplace(Args&&... args) {
+	insert(count, std::forward<Args>(args)...);
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: element at pos removed, an empty chunk is released and a chunk
+//                less than half full absorbs the following chunk if it fits
+template <class T>
+void UnrolledLinkedList<T>::remove(int pos) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("UnrolledLinkedList invalid position: " + std::to_string(pos));
+	}
+	Chunk* c = chunkAt(pos);
+	T* items = c->items();
+	for (int i = pos; i < c->used - 1; i++) {
+		items[i] = std::move(items[i + 1]);
+	}
+	items[c->used - 1].~T();
+	c->used--;
+	count--;
+
+	Chunk* n = c->next;
+	if (c->used == 0) {
+		// unlink empty chunk
+		Chunk* prev = header;
+		while (prev->next != c) {
+			prev = prev->next;
+		}
+		prev->next = n;
+		if (tail == c) { tail = prev; }
+		delete c;
+	}
+	else if (n != nullptr && c->used < Chunk::CAPACITY / 2 && c->used + n->used <= Chunk::CAPACITY) {
+		// merge next chunk into c
+		for (int i = 0; i < n->used; i++) {
+			new (&items[c->used + i]) T(std::move(n->items()[i]));
+			n->items()[i].~T();
+		}
+		c->used += n->used;
+		c->next = n->next;
+		if (tail == n) { tail = c; }
+		delete n;
+	}
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: returns copy of element at pos
+template <class T>
+T UnrolledLinkedList<T>::get(int pos) const {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("UnrolledLinkedList invalid position: " + std::to_string(pos));
+	}
+	Chunk* c = chunkAt(pos);
+	return c->items()[pos];
+}
+
+// PreCondition: pos is a valid position
+// PostCondition: updates element at specified position
+template <class T>
+void UnrolledLinkedList<T>::set(int pos, const T & value) {
+	if (pos < 0 || pos >= size()) {
+		throw std::out_of_range("UnrolledLinkedList invalid position: " + std::to_string(pos));
+	}
+	Chunk* c = chunkAt(pos);
+	c->items()[pos] = value;
+}
+
+// PostCondition: returns index of item if found or -1 if not found
+template <class T>
+int UnrolledLinkedList<T>::find(const T & value) const {
+	int base = 0;
+	for (Chunk* c = header->next; c != nullptr; c = c->next) {
+		const T* items = c->items();
+		for (int i = 0; i < c->used; i++) {
+			if (items[i] == value) {
+				return base + i;
+			}
+		}
+		base += c->used;
+	}
+	return -1;
+}
+
+// PostCondition: UnrolledLinkedList is emptied count == 0;
+template <class T>
+void UnrolledLinkedList<T>::clear() {
+	Chunk* c = header->next;
+	while (c != nullptr) {
+		Chunk* n = c->next;
+		for (int i = 0; i < c->used; i++) {
+			c->items()[i].~T();
+		}
+		delete c;
+		c = n;
+	}
+	header->next = nullptr;
+	tail = header;
+	count = 0;
+}
+
+// PostCondition: prints contents of UnrolledLinkedList to ostream
+template <class T>
+void UnrolledLinkedList<T>::print(std::ostream & os) const {
+	os << "[ ";
+	for (UnrolledIterator<T> itr = begin(); itr != end(); ++itr) {
+		os << (*itr) << " ";
+	}
+	os << "]";
+}
+
+// PreCondition: None
+// PostCondition: overload << operator to output UnrolledLinkedList on ostream
+template <class T>
+std::ostream& operator <<(std::ostream& output, const UnrolledLinkedList<T>& l) {
+	l.print(output);
+	return output;  // for multiple << operators.
+}
+
+#endif /* UNROLLEDLINKEDLIST_H */
@@ -32,10 +32,20 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <sstream>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 namespace picosha2 {
 	typedef unsigned long word_t;
 	typedef unsigned char byte_t;
@@ -141,6 +151,278 @@ namespace picosha2 {
 
 	}  // namespace detail
 
+	// ----------------------- multi-buffer compression ------------------------
+	// Compresses one 64 byte block for each of n independent hash states at a
+	// time. The widest implementation supported by the cpu is selected at run
+	// time, all implementations produce the same output as hash256_block.
+	enum class multi_impl { scalar, sse2, avx2, shani };
+
+	namespace detail {
+		typedef std::uint32_t lane_word_t;
+
+		const lane_word_t lane_constant[64] = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+			0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+			0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+			0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+			0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+			0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+			0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+			0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+			0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+		inline lane_word_t load_be32(const byte_t* p) {
+			return (static_cast<lane_word_t>(p[0]) << 24) | (static_cast<lane_word_t>(p[1]) << 16) |
+				(static_cast<lane_word_t>(p[2]) << 8) | static_cast<lane_word_t>(p[3]);
+		}
+
+		// portable fallback, one lane at a time through hash256_block
+		inline void compress_scalar(lane_word_t* state, const byte_t* block) {
+			word_t h[8];
+			std::copy(state, state + 8, h);
+			hash256_block(h, block, block + 64);
+			for (std::size_t i = 0; i < 8; ++i) {
+				state[i] = static_cast<lane_word_t>(h[i]);
+			}
+		}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PICOSHA2_HAS_X86_SIMD
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PICOSHA2_TARGET(features)
+#else
+#define PICOSHA2_TARGET(features) __attribute__((target(features)))
+#endif
+
+		inline void cpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+			int r[4];
+			__cpuidex(r, leaf, subleaf);
+			for (int i = 0; i < 4; ++i) {
+				regs[i] = static_cast<unsigned int>(r[i]);
+			}
+#else
+			regs[0] = regs[1] = regs[2] = regs[3] = 0;
+			if (static_cast<unsigned int>(leaf) <= __get_cpuid_max(0, nullptr)) {
+				__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+			}
+#endif
+		}
+
+		PICOSHA2_TARGET("xsave") inline unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+			return _xgetbv(0);
+#else
+			unsigned int eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+		}
+
+		// PostCondition: returns true if the cpu can run impl
+		inline bool multi_impl_supported(multi_impl impl) {
+			unsigned int leaf1[4], leaf7[4];
+			cpuid(1, 0, leaf1);
+			cpuid(7, 0, leaf7);
+			bool sse2 = (leaf1[3] >> 26) & 1;
+			bool ssse3 = (leaf1[2] >> 9) & 1;
+			bool sse41 = (leaf1[2] >> 19) & 1;
+			bool osxsave = (leaf1[2] >> 27) & 1;
+			bool avx = osxsave && ((leaf1[2] >> 28) & 1) && (xgetbv0() & 6) == 6;
+			switch (impl) {
+			case multi_impl::shani:
+				return sse2 && ssse3 && sse41 && ((leaf7[1] >> 29) & 1);
+			case multi_impl::avx2:
+				return avx && ((leaf7[1] >> 5) & 1);
+			case multi_impl::sse2:
+				return sse2;
+			default:
+				return true;
+			}
+		}
+
+		inline multi_impl detect_multi_impl() {
+			if (multi_impl_supported(multi_impl::shani)) {
+				return multi_impl::shani;
+			}
+			if (multi_impl_supported(multi_impl::avx2)) {
+				return multi_impl::avx2;
+			}
+			return multi_impl_supported(multi_impl::sse2) ? multi_impl::sse2 : multi_impl::scalar;
+		}
+
+#define PICOSHA2_ROUNDS(V, ADD, XOR, AND, ANDNOT, OR, SRL, SLL, SET1)                       \
+			V s[8], w[64];                                                                   \
+			for (int i = 0; i < 8; ++i) { s[i] = load_state(states, i); }                    \
+			for (int i = 0; i < 16; ++i) { w[i] = load_message(blocks, i); }                 \
+			for (int i = 16; i < 64; ++i) {                                                  \
+				V x = w[i - 15], y = w[i - 2];                                               \
+				V s0 = XOR(XOR(OR(SRL(x, 7), SLL(x, 25)), OR(SRL(x, 18), SLL(x, 14))), SRL(x, 3));   \
+				V s1 = XOR(XOR(OR(SRL(y, 17), SLL(y, 15)), OR(SRL(y, 19), SLL(y, 13))), SRL(y, 10)); \
+				w[i] = ADD(ADD(s1, w[i - 7]), ADD(s0, w[i - 16]));                           \
+			}                                                                                \
+			V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7]; \
+			for (int i = 0; i < 64; ++i) {                                                   \
+				V S1 = XOR(XOR(OR(SRL(e, 6), SLL(e, 26)), OR(SRL(e, 11), SLL(e, 21))), OR(SRL(e, 25), SLL(e, 7))); \
+				V ch = XOR(AND(e, f), ANDNOT(e, g));                                         \
+				V t1 = ADD(ADD(ADD(h, S1), ADD(ch, SET1(static_cast<int>(lane_constant[i])))), w[i]); \
+				V S0 = XOR(XOR(OR(SRL(a, 2), SLL(a, 30)), OR(SRL(a, 13), SLL(a, 19))), OR(SRL(a, 22), SLL(a, 10))); \
+				V mj = XOR(XOR(AND(a, b), AND(a, c)), AND(b, c));                            \
+				h = g; g = f; f = e; e = ADD(d, t1);                                         \
+				d = c; c = b; b = a; a = ADD(t1, ADD(S0, mj));                               \
+			}                                                                                \
+			s[0] = ADD(s[0], a); s[1] = ADD(s[1], b); s[2] = ADD(s[2], c); s[3] = ADD(s[3], d); \
+			s[4] = ADD(s[4], e); s[5] = ADD(s[5], f); s[6] = ADD(s[6], g); s[7] = ADD(s[7], h); \
+			for (int i = 0; i < 8; ++i) { store_state(states, i, s[i]); }
+
+		// 4 lanes of 32 bit words in SSE2 registers
+		struct sse2_x4 {
+			PICOSHA2_TARGET("sse2") static __m128i load_state(lane_word_t* const* states, int i) {
+				return _mm_set_epi32(static_cast<int>(states[3][i]), static_cast<int>(states[2][i]),
+					static_cast<int>(states[1][i]), static_cast<int>(states[0][i]));
+			}
+			PICOSHA2_TARGET("sse2") static __m128i load_message(const byte_t* const* blocks, int i) {
+				return _mm_set_epi32(static_cast<int>(load_be32(blocks[3] + 4 * i)), static_cast<int>(load_be32(blocks[2] + 4 * i)),
+					static_cast<int>(load_be32(blocks[1] + 4 * i)), static_cast<int>(load_be32(blocks[0] + 4 * i)));
+			}
+			PICOSHA2_TARGET("sse2") static void store_state(lane_word_t* const* states, int i, __m128i v) {
+				alignas(16) lane_word_t out[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(out), v);
+				for (int lane = 0; lane < 4; ++lane) {
+					states[lane][i] = out[lane];
+				}
+			}
+			PICOSHA2_TARGET("sse2") static void compress(lane_word_t* const* states, const byte_t* const* blocks) {
+				PICOSHA2_ROUNDS(__m128i, _mm_add_epi32, _mm_xor_si128, _mm_and_si128, _mm_andnot_si128,
+					_mm_or_si128, _mm_srli_epi32, _mm_slli_epi32, _mm_set1_epi32)
+			}
+		};
+
+		// 8 lanes of 32 bit words in AVX2 registers
+		struct avx2_x8 {
+			PICOSHA2_TARGET("avx2") static __m256i load_state(lane_word_t* const* states, int i) {
+				return _mm256_set_epi32(static_cast<int>(states[7][i]), static_cast<int>(states[6][i]),
+					static_cast<int>(states[5][i]), static_cast<int>(states[4][i]),
+					static_cast<int>(states[3][i]), static_cast<int>(states[2][i]),
+					static_cast<int>(states[1][i]), static_cast<int>(states[0][i]));
+			}
+			PICOSHA2_TARGET("avx2") static __m256i load_message(const byte_t* const* blocks, int i) {
+				return _mm256_set_epi32(static_cast<int>(load_be32(blocks[7] + 4 * i)), static_cast<int>(load_be32(blocks[6] + 4 * i)),
+					static_cast<int>(load_be32(blocks[5] + 4 * i)), static_cast<int>(load_be32(blocks[4] + 4 * i)),
+					static_cast<int>(load_be32(blocks[3] + 4 * i)), static_cast<int>(load_be32(blocks[2] + 4 * i)),
+					static_cast<int>(load_be32(blocks[1] + 4 * i)), static_cast<int>(load_be32(blocks[0] + 4 * i)));
+			}
+			PICOSHA2_TARGET("avx2") static void store_state(lane_word_t* const* states, int i, __m256i v) {
+				alignas(32) lane_word_t out[8];
+				_mm256_store_si256(reinterpret_cast<__m256i*>(out), v);
+				for (int lane = 0; lane < 8; ++lane) {
+					states[lane][i] = out[lane];
+				}
+			}
+			PICOSHA2_TARGET("avx2") static void compress(lane_word_t* const* states, const byte_t* const* blocks) {
+				PICOSHA2_ROUNDS(__m256i, _mm256_add_epi32, _mm256_xor_si256, _mm256_and_si256, _mm256_andnot_si256,
+					_mm256_or_si256, _mm256_srli_epi32, _mm256_slli_epi32, _mm256_set1_epi32)
+			}
+		};
+#undef PICOSHA2_ROUNDS
+
+		// one lane using the SHA extensions
+		PICOSHA2_TARGET("sha,sse4.1,ssse3") inline void compress_shani(lane_word_t* state, const byte_t* block) {
+			const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+			__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);	// CDAB
+			__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);	// EFGH
+			__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);	// ABEF
+			state1 = _mm_blend_epi16(state1, tmp, 0xF0);		// CDGH
+			const __m128i abef = state0, cdgh = state1;
+
+			__m128i msg[4];
+			for (int g = 0; g < 16; ++g) {
+				if (g < 4) {
+					msg[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * g)), byte_swap);
+				}
+				else {
+					__m128i x = _mm_sha256msg1_epu32(msg[g % 4], msg[(g + 1) % 4]);
+					x = _mm_add_epi32(x, _mm_alignr_epi8(msg[(g + 3) % 4], msg[(g + 2) % 4], 4));
+					msg[g % 4] = _mm_sha256msg2_epu32(x, msg[(g + 3) % 4]);
+				}
+				__m128i m = _mm_add_epi32(msg[g % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane_constant + 4 * g)));
+				state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+				state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(m, 0x0E));
+			}
+
+			state0 = _mm_add_epi32(state0, abef);
+			state1 = _mm_add_epi32(state1, cdgh);
+			tmp = _mm_shuffle_epi32(state0, 0x1B);				// FEBA
+			state1 = _mm_shuffle_epi32(state1, 0xB1);			// DCHG
+			state0 = _mm_blend_epi16(tmp, state1, 0xF0);		// DCBA
+			state1 = _mm_alignr_epi8(state1, tmp, 8);			// HGFE
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+		}
+#undef PICOSHA2_TARGET
+#else
+		inline bool multi_impl_supported(multi_impl impl) { return impl == multi_impl::scalar; }
+		inline multi_impl detect_multi_impl() { return multi_impl::scalar; }
+#endif
+
+		inline multi_impl& selected_multi_impl() {
+			static multi_impl impl = detect_multi_impl();
+			return impl;
+		}
+
+		// PostCondition: one block compressed into each of the n states
+		inline void compress_multi(lane_word_t* const* states, const byte_t* const* blocks, std::size_t n) {
+			std::size_t i = 0;
+#ifdef PICOSHA2_HAS_X86_SIMD
+			switch (selected_multi_impl()) {
+			case multi_impl::shani:
+				for (; i < n; ++i) {
+					compress_shani(states[i], blocks[i]);
+				}
+				break;
+			case multi_impl::avx2:
+				for (; i + 8 <= n; i += 8) {
+					avx2_x8::compress(states + i, blocks + i);
+				}
+				// fall through for remaining lanes
+			case multi_impl::sse2:
+				for (; i + 4 <= n; i += 4) {
+					sse2_x4::compress(states + i, blocks + i);
+				}
+				break;
+			default:
+				break;
+			}
+#endif
+			for (; i < n; ++i) {
+				compress_scalar(states[i], blocks[i]);
+			}
+		}
+	}  // namespace detail
+
+	// PostCondition: returns implementation used for multi-buffer hashing
+	inline multi_impl get_multi_impl() { return detail::selected_multi_impl(); }
+
+	// PostCondition: returns fastest implementation supported by the cpu
+	inline multi_impl supported_multi_impl() { return detail::detect_multi_impl(); }
+
+	// PostCondition: returns true if the cpu can run impl
+	inline bool is_multi_impl_supported(multi_impl impl) { return detail::multi_impl_supported(impl); }
+
+	// PostCondition: impl used for subsequent multi-buffer hashing, an implementation the
+	//                cpu cannot run is replaced by the next narrower one it can
+	inline void set_multi_impl(multi_impl impl) {
+		while (!detail::multi_impl_supported(impl)) {
+			impl = static_cast<multi_impl>(static_cast<int>(impl) - 1);
+		}
+		detail::selected_multi_impl() = impl;
+	}
+
+	// number of messages hashed together for best use of the widest lanes
+	static const std::size_t k_multi_lanes = 8;
+
 	template <typename InIter>
 	void output_hex(InIter first, InIter last, std::ostream& os) {
 		os.setf(std::ios::hex, std::ios::basefield);
@@ -232,7 +514,95 @@ namespace picosha2 {
 			}
 		}
 
+		// PostCondition: digest of the data processed so far followed by tails[i] is
+		//                written to digests + k_digest_size * i for each of the n tails,
+		//                the tails are compressed together using the multi-buffer kernel
+		void finish_multi(const byte_t* const* tails, const std::size_t* lengths,
+			std::size_t n, byte_t* digests) const {
+			// lanes are finished k_multi_lanes at a time so all scratch space is fixed size
+			for (std::size_t first = 0; first < n; first += k_multi_lanes) {
+				finish_lanes(tails + first, lengths + first, std::min(n - first, k_multi_lanes),
+					digests + first * k_digest_size);
+			}
+		}
+
 	private:
+		// PreCondition:  n <= k_multi_lanes
+		// PostCondition: as finish_multi, without allocating
+		void finish_lanes(const byte_t* const* tails, const std::size_t* lengths,
+			std::size_t n, byte_t* digests) const {
+			std::uint64_t prefix_length = 0;
+			for (int i = 3; i >= 0; --i) {
+				prefix_length = (prefix_length << 16) | data_length_digits_[i];
+			}
+
+			// padded length of buffered data + tail of each lane in whole blocks
+			std::size_t blocks[k_multi_lanes];
+			detail::lane_word_t state[k_multi_lanes][8];
+			std::size_t max_blocks = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				blocks[i] = (buffer_.size() + lengths[i] + 8) / 64 + 1;
+				max_blocks = std::max(max_blocks, blocks[i]);
+				std::copy(h_, h_ + 8, state[i]);
+			}
+
+			// compress block k of every lane that still has one
+			byte_t scratch[k_multi_lanes][64];
+			detail::lane_word_t* lane_states[k_multi_lanes];
+			const byte_t* lane_blocks[k_multi_lanes];
+			for (std::size_t k = 0; k < max_blocks; ++k) {
+				std::size_t lanes = 0;
+				for (std::size_t i = 0; i < n; ++i) {
+					if (k < blocks[i]) {
+						lane_states[lanes] = state[i];
+						lane_blocks[lanes] = padded_block(tails[i], lengths[i], prefix_length, k,
+							blocks[i], scratch[lanes]);
+						++lanes;
+					}
+				}
+				detail::compress_multi(lane_states, lane_blocks, lanes);
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				for (std::size_t w = 0; w < 8; ++w) {
+					for (std::size_t b = 0; b < 4; ++b) {
+						digests[i * k_digest_size + w * 4 + b] = static_cast<byte_t>(state[i][w] >> (24 - 8 * b));
+					}
+				}
+			}
+		}
+
+		// PostCondition: returns block k of buffered data + tail padded to total blocks,
+		//                read in place from the tail when possible, otherwise built in scratch
+		const byte_t* padded_block(const byte_t* tail, std::size_t length, std::uint64_t prefix_length,
+			std::size_t k, std::size_t total, byte_t* scratch) const {
+			std::size_t buffered = buffer_.size();
+			std::size_t end = buffered + length;	// end of message within the padded blocks
+			std::size_t start = k * 64;
+			if (start >= buffered && start + 64 <= end) {
+				return tail + (start - buffered);
+			}
+			std::fill(scratch, scratch + 64, static_cast<byte_t>(0));
+			if (start < buffered) {
+				std::copy(buffer_.begin() + start, buffer_.begin() + std::min(buffered, start + 64), scratch);
+			}
+			std::size_t from = std::max(start, buffered);
+			std::size_t to = std::min(start + 64, end);
+			if (from < to) {
+				std::copy(tail + (from - buffered), tail + (to - buffered), scratch + (from - start));
+			}
+			if (end >= start && end < start + 64) {
+				scratch[end - start] = 0x80;
+			}
+			if (k == total - 1) {
+				std::uint64_t bit_length = (prefix_length + length) * 8;
+				for (std::size_t b = 0; b < 8; ++b) {
+					scratch[63 - b] = static_cast<byte_t>(bit_length >> (8 * b));
+				}
+			}
+			return scratch;
+		}
+
 		void add_to_data_length(word_t n) {
 			word_t carry = 0;
 			data_length_digits_[0] += n;
@@ -286,6 +656,13 @@ namespace picosha2 {
 		return hex_str;
 	}
 
+	// PostCondition: SHA256 digest of each of the n messages is written to
+	//                digests + k_digest_size * i, hashed together in SIMD lanes
+	inline void hash256_multi(const byte_t* const* messages, const std::size_t* lengths,
+		std::size_t n, byte_t* digests) {
+		hash256_one_by_one().finish_multi(messages, lengths, n, digests);
+	}
+
 	namespace impl {
 		template <typename RaIter, typename OutIter>
 		void hash256_impl(RaIter first, RaIter last, OutIter first2, OutIter last2, int,
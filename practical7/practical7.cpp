@@ -8,10 +8,21 @@
 
 #include <iostream>
 #include <string>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <exception>
+#include <functional>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "LinkedList.h"
+#include "UnrolledLinkedList.h"
+#include "SkipList.h"
+#include "DList.h"
+#include "ConcurrentQueue.h"
 #include "BlockChain.h"
 
 using namespace std;
@@ -140,37 +151,314 @@ void Q1d()
 
 
 // --------------------------------QUESTIONs 2 3 & 4 ---------------------------------------- -
+// The set operations are generic over LinkedList and ArrayList. The hashed versions
+// build a hash set over one input so run in O(n+m) expected time, the sorted versions
+// merge inputs that are already in ascending order in O(n+m) time.
+
+// PostCondition: f called with each element of LinkedList l in order
+template <class T, class F>
+void forEach(const LinkedList<T> & l, F f)
+{
+	for (ListIterator<T> itr = l.begin(); itr != l.end(); itr++) {
+		f(*itr);
+	}
+}
+
+// PostCondition: f called with each element of ArrayList l in order
+template <class T, class F>
+void forEach(const ArrayList<T> & l, F f)
+{
+	for (const T & e : l) {
+		f(e);
+	}
+}
+
+// PostCondition: returns hash set of the elements of List l
+template <template <class> class List, class T>
+unordered_set<T> toHashSet(const List<T> & l)
+{
+	unordered_set<T> set(l.size());
+	forEach(l, [&set](const T & e) { set.insert(e); });
+	return set;
+}
 
 // PostCondition: Determine the intersection of List a and List b and 
 //                return result in in List c.
-//                i.e. elements contained in both Lists a and b
-template <class T>
-void listIntersection(const LinkedList<T> & a, const LinkedList<T> & b, LinkedList<T> & c)
+//                i.e. elements contained in both Lists a and b (in order of a, not repeated)
+template <template <class> class List, class T>
+void listIntersection(const List<T> & a, const List<T> & b, List<T> & c)
 {
-	// complete
-	
+	unordered_set<T> inB = toHashSet(b);
+	forEach(a, [&](const T & e) {
+		if (inB.erase(e) > 0) {		// erase so repeated elements of a are added once
+			c.add(e);
+		}
+	});
 }
 
 
 // PostCondition: Determine the union of List a and List b and 
 //                return result in in List c.
-//                i.e. all elements in both Lists (not repeated)
-template <class T>
-void listUnion(const LinkedList<T> & a, const LinkedList<T> & b, LinkedList<T> & c)
+//                i.e. all elements in both Lists (not repeated), elements of a then b
+template <template <class> class List, class T>
+void listUnion(const List<T> & a, const List<T> & b, List<T> & c)
 {
-	// complete
+	unordered_set<T> seen(a.size() + b.size());
+	auto addNew = [&](const T & e) {
+		if (seen.insert(e).second) {
+			c.add(e);
+		}
+	};
+	forEach(a, addNew);
+	forEach(b, addNew);
 }
 
 
 // PostCondition: Populate list c with difference of List a and List b 
-//                i.e. elements of List a, which do not belong to List b.
+//                i.e. elements of List a, which do not belong to List b (not repeated).
+template <template <class> class List, class T>
+void listDifference(const List<T> & a, const List<T> & b, List<T> & c) {
+	unordered_set<T> excluded = toHashSet(b);
+	forEach(a, [&](const T & e) {
+		if (excluded.insert(e).second) {	// insert so repeated elements of a are added once
+			c.add(e);
+		}
+	});
+}
+
+// Sequential read cursors so sorted merges treat LinkedList and ArrayList alike
+template <class T>
+class LinkedListCursor {
+public:
+	LinkedListCursor(const LinkedList<T> & l) : itr(l.begin()), last(l.end()) {}
+	bool done()				{ return !(itr != last); }
+	const T & value()		{ return *itr; }
+	void next()				{ ++itr; }
+private:
+	ListIterator<T> itr, last;
+};
+
 template <class T>
-void listDifference(const LinkedList<T> & a, const LinkedList<T> & b, LinkedList<T> & c) {
-	// complete
+class ArrayListCursor {
+public:
+	ArrayListCursor(const ArrayList<T> & l) : list(l), pos(0) {}
+	bool done() const		{ return pos >= list.size(); }
+	const T & value()		{ return list.data()[pos]; }
+	void next()				{ pos++; }
+private:
+	const ArrayList<T> & list;
+	int pos;
+};
+
+template <class T> LinkedListCursor<T> cursor(const LinkedList<T> & l) { return LinkedListCursor<T>(l); }
+template <class T> ArrayListCursor<T> cursor(const ArrayList<T> & l) { return ArrayListCursor<T>(l); }
+
+// PreCondition:  a and b are sorted in ascending order
+// PostCondition: single merge pass over a and b adding to c the elements only in a
+//                (onlyA), in both (both) and only in b (onlyB), ascending and not repeated
+template <template <class> class List, class T>
+void sortedMerge(const List<T> & a, const List<T> & b, List<T> & c, bool onlyA, bool both, bool onlyB)
+{
+	auto ca = cursor(a);
+	auto cb = cursor(b);
+	T last{};
+	bool any = false;
+	auto emit = [&](const T & e) {
+		if (!any || last < e) {
+			c.add(e);
+			last = e;
+			any = true;
+		}
+	};
+	while (!ca.done() && !cb.done()) {
+		const T & x = ca.value();
+		const T & y = cb.value();
+		if (x < y) {
+			if (onlyA) { emit(x); }
+			ca.next();
+		}
+		else if (y < x) {
+			if (onlyB) { emit(y); }
+			cb.next();
+		}
+		else {
+			if (both) { emit(x); }
+			ca.next();
+			cb.next();
+		}
+	}
+	for (; onlyA && !ca.done(); ca.next()) { emit(ca.value()); }
+	for (; onlyB && !cb.done(); cb.next()) { emit(cb.value()); }
+}
+
+// PreCondition:  a and b are sorted in ascending order
+// PostCondition: c contains the elements common to a and b, ascending and not repeated
+template <template <class> class List, class T>
+void sortedListIntersection(const List<T> & a, const List<T> & b, List<T> & c)
+{
+	sortedMerge(a, b, c, false, true, false);
+}
+
+// PreCondition:  a and b are sorted in ascending order
+// PostCondition: c contains the elements of a or b, ascending and not repeated
+template <template <class> class List, class T>
+void sortedListUnion(const List<T> & a, const List<T> & b, List<T> & c)
+{
+	sortedMerge(a, b, c, true, true, true);
+}
+
+// PreCondition:  a and b are sorted in ascending order
+// PostCondition: c contains the elements of a not in b, ascending and not repeated
+template <template <class> class List, class T>
+void sortedListDifference(const List<T> & a, const List<T> & b, List<T> & c)
+{
+	sortedMerge(a, b, c, true, false, false);
+}
+
+
+// ------------------------- Parallel List Set Operations -----------------------------
+// Both inputs are hash partitioned into one bucket per thread. Equal elements always
+// fall in the same bucket, so each thread decides independently which of its elements
+// are kept; the kept elements are then added to c in input order, giving exactly the
+// same result as the sequential versions.
+
+enum class SetOperation { Intersection, Union, Difference };
+
+// PostCondition: returns references to the elements of List l in order
+template <template <class> class List, class T>
+vector<const T *> elementRefs(const List<T> & l)
+{
+	vector<const T *> refs;
+	refs.reserve(l.size());
+	forEach(l, [&refs](const T & e) { refs.push_back(&e); });
+	return refs;
+}
+
+// PostCondition: c populated with result of op on a and b using numThreads threads
+//                (0 selects one per hardware thread)
+template <template <class> class List, class T>
+void parallelSetOperation(const List<T> & a, const List<T> & b, List<T> & c, SetOperation op, int numThreads = 0)
+{
+	if (numThreads <= 0) {
+		numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+	}
+	vector<const T *> ea = elementRefs(a);
+	vector<const T *> eb = elementRefs(b);
+
+	// run f(t) on each of numThreads threads
+	auto runThreads = [numThreads](function<void(int)> f) {
+		vector<thread> workers;
+		for (int t = 1; t < numThreads; t++) {
+			workers.emplace_back(f, t);
+		}
+		f(0);
+		for (thread & w : workers) {
+			w.join();
+		}
+	};
+
+	// phase 1: each thread partitions a slice of a and b by hash into per bucket index lists
+	// parts[t][p] holds indices from slice t belonging to bucket p
+	vector<vector<vector<int>>> partsA(numThreads, vector<vector<int>>(numThreads));
+	vector<vector<vector<int>>> partsB(numThreads, vector<vector<int>>(numThreads));
+	runThreads([&](int t) {
+		hash<T> hasher;
+		int fromA = static_cast<int>(ea.size() * t / numThreads), toA = static_cast<int>(ea.size() * (t + 1) / numThreads);
+		for (int i = fromA; i < toA; i++) {
+			partsA[t][hasher(*ea[i]) % numThreads].push_back(i);
+		}
+		int fromB = static_cast<int>(eb.size() * t / numThreads), toB = static_cast<int>(eb.size() * (t + 1) / numThreads);
+		for (int j = fromB; j < toB; j++) {
+			partsB[t][hasher(*eb[j]) % numThreads].push_back(j);
+		}
+	});
+
+	// phase 2: each thread decides which elements of its bucket are kept, visiting
+	// indices in ascending order (slices are in order) just as the sequential version
+	vector<char> keepA(ea.size(), 0), keepB(eb.size(), 0);
+	runThreads([&](int p) {
+		unordered_set<T> set;
+		if (op != SetOperation::Union) {
+			for (int t = 0; t < numThreads; t++) {
+				for (int j : partsB[t][p]) {
+					set.insert(*eb[j]);
+				}
+			}
+		}
+		for (int t = 0; t < numThreads; t++) {
+			for (int i : partsA[t][p]) {
+				keepA[i] = (op == SetOperation::Intersection) ? (set.erase(*ea[i]) > 0) : set.insert(*ea[i]).second;
+			}
+		}
+		if (op == SetOperation::Union) {
+			for (int t = 0; t < numThreads; t++) {
+				for (int j : partsB[t][p]) {
+					keepB[j] = set.insert(*eb[j]).second;
+				}
+			}
+		}
+	});
+
+	// phase 3: add kept elements in input order
+	for (size_t i = 0; i < ea.size(); i++) {
+		if (keepA[i]) { c.add(*ea[i]); }
+	}
+	for (size_t j = 0; j < eb.size(); j++) {
+		if (keepB[j]) { c.add(*eb[j]); }
+	}
+}
+
+// PostCondition: same result as listIntersection computed using numThreads threads
+template <template <class> class List, class T>
+void parallelListIntersection(const List<T> & a, const List<T> & b, List<T> & c, int numThreads = 0)
+{
+	parallelSetOperation(a, b, c, SetOperation::Intersection, numThreads);
+}
+
+// PostCondition: same result as listUnion computed using numThreads threads
+template <template <class> class List, class T>
+void parallelListUnion(const List<T> & a, const List<T> & b, List<T> & c, int numThreads = 0)
+{
+	parallelSetOperation(a, b, c, SetOperation::Union, numThreads);
+}
+
+// PostCondition: same result as listDifference computed using numThreads threads
+template <template <class> class List, class T>
+void parallelListDifference(const List<T> & a, const List<T> & b, List<T> & c, int numThreads = 0)
+{
+	parallelSetOperation(a, b, c, SetOperation::Difference, numThreads);
 }
 
 
 // ---------------------- Demo of the List Set Operations ---------------------------
+
+// PostCondition: prints whether check passed
+void report(const string & name, bool passed)
+{
+	cout << name << ": " << (passed ? "passed" : "FAILED") << "\n";
+}
+
+// PostCondition: returns true if the parallel set operations give the same result as
+//                the sequential versions on List a and b
+template <template <class> class List, class T>
+bool parallelMatchesSequential(const List<T> & a, const List<T> & b, int numThreads)
+{
+	List<T> seq, par;
+	listIntersection(a, b, seq);
+	parallelListIntersection(a, b, par, numThreads);
+	bool same = (seq == par);
+	seq.clear(); par.clear();
+
+	listUnion(a, b, seq);
+	parallelListUnion(a, b, par, numThreads);
+	same = same && (seq == par);
+	seq.clear(); par.clear();
+
+	listDifference(a, b, seq);
+	parallelListDifference(a, b, par, numThreads);
+	return same && (seq == par);
+}
+
 void testListSetOperations()
 {
 	LinkedList<int> a, b, c;
@@ -196,11 +484,490 @@ void testListSetOperations()
 	cout << "Difference : " << c << "\n";
 	c.clear();
 
+	// Test sorted merge versions on ArrayLists
+	ArrayList<int> sa, sb, sc;
+	sa.add(1); sa.add(2); sa.add(4); sa.add(5); sa.add(7);
+	sb.add(3); sb.add(5); sb.add(7); sb.add(11);
+
+	sortedListIntersection(sa, sb, sc);
+	cout << "Sorted Intersection:  " << sc << "\n";
+	sc.clear();
+
+	sortedListUnion(sa, sb, sc);
+	cout << "Sorted Union:  " << sc << "\n";
+	sc.clear();
+
+	sortedListDifference(sa, sb, sc);
+	cout << "Sorted Difference : " << sc << "\n";
+
+	// Test parallel versions against the sequential ones, with repeated elements
+	LinkedList<int> la, lb;
+	ArrayList<int> aa, ab;
+	for (int i = 0; i < 20000; i++) {
+		la.add((i * 7919) % 10007);   aa.add((i * 7919) % 10007);
+		lb.add((i * 104729) % 15013); ab.add((i * 104729) % 15013);
+	}
+	report("Parallel (LinkedList, 4 threads)", parallelMatchesSequential(la, lb, 4));
+	report("Parallel (ArrayList, 3 threads)", parallelMatchesSequential(aa, ab, 3));
+	report("Parallel (small lists)", parallelMatchesSequential(a, b, 0));
+
+	cout << "\n";
+}
+
+// ---------------------- Timing of the checks ---------------------------
+
+// PostCondition: returns seconds taken to run f
+template <class F>
+double timeIt(F f)
+{
+	auto start = chrono::steady_clock::now();
+	f();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// ---------------------- Checks of the alternative Lists ---------------------------
+// Each List with the LinkedList interface is driven by the same random sequence of
+// positional operations as a LinkedList, which serves as the reference
+
+// PostCondition: returns true if List l holds the same elements as reference, in order
+template <class List, class T>
+bool sameElements(const List & l, const LinkedList<T> & reference)
+{
+	if (l.size() != reference.size()) {
+		return false;
+	}
+	ListIterator<T> r = reference.begin();
+	for (const T & e : l) {
+		if (e != *r) {
+			return false;
+		}
+		++r;
+	}
+	return true;
+}
+
+// PostCondition: returns true if List behaves as a LinkedList over a random mix of
+//                adds, positional inserts and removes, sets, gets, finds, copies,
+//                moves and clears
+template <class List>
+bool matchesLinkedList(int operations, unsigned seed)
+{
+	mt19937 rng(seed);
+	List l;
+	LinkedList<string> reference;
+	bool same = true;
+	for (int i = 0; i < operations && same; i++) {
+		int n = reference.size();
+		string value = "value-" + to_string(rng() % 1000);
+		switch (rng() % 8) {
+		case 0: case 1:
+			l.add(value); reference.add(value);
+			break;
+		case 2: case 3: {
+			int pos = static_cast<int>(rng() % (n + 1));
+			l.add(pos, value); reference.add(pos, value);
+			break;
+		}
+		case 4:
+			if (n > 0) {
+				int pos = static_cast<int>(rng() % n);
+				l.remove(pos); reference.remove(pos);
+			}
+			break;
+		case 5:
+			if (n > 0) {
+				int pos = static_cast<int>(rng() % n);
+				l.set(pos, value); reference.set(pos, value);
+			}
+			break;
+		case 6:
+			if (n > 0) {
+				int pos = static_cast<int>(rng() % n);
+				same = (l.get(pos) == reference.get(pos));
+			}
+			same = same && (l.find(value) == reference.find(value));
+			break;
+		default:
+			if (rng() % 50 == 0) {
+				List copy(l);
+				List moved(std::move(copy));
+				same = sameElements(copy, LinkedList<string>()) && sameElements(moved, reference);
+				l = moved;
+			}
+			else if (rng() % 400 == 0) {
+				l.clear(); reference.clear();
+			}
+			break;
+		}
+		if (i % 500 == 0) {
+			same = same && sameElements(l, reference);
+		}
+	}
+	return same && sameElements(l, reference);
+}
+
+// PostCondition: returns seconds taken by n mid-list inserts into List and by 100
+//                traversals of the result
+template <class List>
+pair<double, double> timeInsertAndTraverse(List & l, int n, long long & sum)
+{
+	double insert = timeIt([&] { for (int i = 0; i < n; i++) { l.add(l.size() / 2, i); } });
+	double traverse = timeIt([&] { for (int r = 0; r < 100; r++) { for (int e : l) { sum += e; } } });
+	return make_pair(insert, traverse);
+}
+
+void testUnrolledLinkedList()
+{
+	cout << " -- UnrolledLinkedList --\n";
+	report("Random operations against LinkedList", matchesLinkedList<UnrolledLinkedList<string>>(20000, 13));
+
+	// mid-list insertion and traversal compared with LinkedList
+	const int N = 10000;
+	long long sum = 0;
+	LinkedList<int> linked;
+	UnrolledLinkedList<int> unrolled;
+	pair<double, double> l = timeInsertAndTraverse(linked, N, sum);
+	pair<double, double> u = timeInsertAndTraverse(unrolled, N, sum);
+	report("Same contents as LinkedList", sameElements(unrolled, linked));
+	cout << N << " mid-list inserts: LinkedList " << l.first << "s, UnrolledLinkedList " << u.first
+		<< "s (" << l.first / u.first << "x faster)\n";
+	cout << "100 traversals:      LinkedList " << l.second << "s, UnrolledLinkedList " << u.second
+		<< "s (" << l.second / u.second << "x faster)\n\n";
+}
+
+// PostCondition: returns seconds taken by a get(i) loop over every position of List
+template <class List>
+double timeGetLoop(const List & l, long long & sum)
+{
+	return timeIt([&] { for (int i = 0; i < l.size(); i++) { sum += l.get(i); } });
+}
+
+void testSkipList()
+{
+	cout << " -- SkipList --\n";
+	report("Random operations against LinkedList", matchesLinkedList<SkipList<string>>(20000, 17));
+
+	// positional insertion and get(i) compared with LinkedList
+	const int N = 10000;
+	long long sum = 0;
+	LinkedList<int> linked;
+	SkipList<int> skip;
+	pair<double, double> l = timeInsertAndTraverse(linked, N, sum);
+	pair<double, double> s = timeInsertAndTraverse(skip, N, sum);
+	report("Same contents as LinkedList", sameElements(skip, linked));
+	double lget = timeGetLoop(linked, sum);
+	double sget = timeGetLoop(skip, sum);
+	cout << N << " mid-list inserts: LinkedList " << l.first << "s, SkipList " << s.first
+		<< "s (" << l.first / s.first << "x faster)\n";
+	cout << "get(i) loop:         LinkedList " << lget << "s, SkipList " << sget
+		<< "s (" << lget / sget << "x faster)\n\n";
+}
+
+// PostCondition: returns the elements of l in order, read forwards or backwards
+vector<int> elementsOf(const DList<int> & l, bool backwards = false)
+{
+	vector<int> v;
+	if (backwards) {
+		for (DListIterator<int> itr = l.end(); itr != l.begin(); ) {
+			v.push_back(*(--itr));
+		}
+	}
+	else {
+		for (int e : l) { v.push_back(e); }
+	}
+	return v;
+}
+
+void testDList()
+{
+	cout << " -- DList --\n";
+	report("Random operations against LinkedList", matchesLinkedList<DList<string>>(20000, 19));
+
+	// erase returns the element following the one removed
+	DList<int> l;
+	for (int i = 0; i < 10; i++) { l.add(i); }
+	for (DListIterator<int> itr = l.begin(); itr != l.end(); ) {
+		itr = (*itr % 2 == 0) ? l.erase(itr) : ++itr;
+	}
+	report("erase returns next", elementsOf(l) == vector<int>{ 1, 3, 5, 7, 9 } && l.size() == 5
+		&& l.erase(--l.end()) == l.end() && elementsOf(l, true) == vector<int>{ 7, 5, 3, 1 });
+
+	// splice a single element from another list and within the same list
+	DList<int> other;
+	for (int i = 10; i < 13; i++) { other.add(i); }
+	DListIterator<int> moved = ++other.begin();		// 11
+	l.splice(l.begin(), other, moved);
+	l.splice(l.end(), l, l.begin());				// 11 to the back of l
+	report("splice single element", elementsOf(l) == vector<int>{ 1, 3, 5, 7, 11 } && l.size() == 5
+		&& elementsOf(other) == vector<int>{ 10, 12 } && other.size() == 2 && *moved == 11
+		&& elementsOf(l, true) == vector<int>{ 11, 7, 5, 3, 1 });
+
+	// splice a whole list into the middle
+	l.splice(++l.begin(), other);
+	l.splice(l.begin(), other);						// other is now empty, no change
+	report("splice whole list", elementsOf(l) == vector<int>{ 1, 10, 12, 3, 5, 7, 11 } && l.size() == 7
+		&& other.isEmpty() && other.begin() == other.end()
+		&& elementsOf(l, true) == vector<int>{ 11, 7, 5, 3, 12, 10, 1 });
+
+	// access and removal at both ends
+	bool ends = l.front() == 1 && l.back() == 11;
+	l.front() = 0;
+	l.removeBack();
+	l.removeFront();
+	ends = ends && l.front() == 10 && l.back() == 7 && elementsOf(l) == vector<int>{ 10, 12, 3, 5, 7 };
+	while (!l.isEmpty()) { l.removeBack(); }
+	bool thrown = false;
+	try { l.removeFront(); }
+	catch (const out_of_range &) { thrown = true; }
+	report("front, back, removeFront and removeBack", ends && thrown && l.size() == 0 && l.begin() == l.end());
+	cout << "\n";
+}
+
+// ---------------------- Check of the lock-free queue ---------------------------
+
+// PostCondition: every item enqueued on a ConcurrentQueue is dequeued exactly once (same
+//                count and sum) and in the order each producer enqueued them, also when
+//                threads exit while others may still have their retired nodes published
+void testConcurrentQueue()
+{
+	cout << " -- ConcurrentQueue --\n";
+	const int PRODUCERS = 4, CONSUMERS = 4, ITEMS = 20000;
+	ConcurrentQueue<long long> queue;
+	atomic<long long> dequeued{ 0 }, sum{ 0 };
+	atomic<bool> ordered{ true };
+
+	vector<thread> threads;
+	for (int p = 0; p < PRODUCERS; p++) {
+		threads.emplace_back([&, p] {
+			for (int i = 0; i < ITEMS; i++) { queue.enqueue(static_cast<long long>(p) * ITEMS + i); }
+		});
+	}
+	for (int c = 0; c < CONSUMERS; c++) {
+		threads.emplace_back([&] {
+			vector<long long> last(PRODUCERS, -1);	// last item dequeued from each producer
+			long long v;
+			while (dequeued.load() < PRODUCERS * ITEMS) {
+				if (queue.tryDequeue(v)) {
+					int p = static_cast<int>(v / ITEMS);
+					if (v <= last[p]) { ordered = false; }
+					last[p] = v;
+					sum += v;
+					dequeued++;
+				}
+				else {
+					this_thread::yield();
+				}
+			}
+		});
+	}
+	for (thread & t : threads) { t.join(); }
+	long long n = static_cast<long long>(PRODUCERS) * ITEMS;
+	report("Producers and consumers: count and sum", dequeued == n && sum == n * (n - 1) / 2
+		&& queue.isEmpty() && queue.size() == 0);
+	report("FIFO order of each producer", ordered);
+
+	// short-lived threads, several times HazardPointers::MAXTHREADS in total, each retiring
+	// nodes a long-lived consumer may still have published when the thread exits
+	const int CHURN = 3 * HazardPointers::MAXTHREADS, BATCH = 4, EACH = 100;
+	atomic<bool> done{ false }, failed{ false };
+	dequeued = 0;
+	sum = 0;
+	thread consumer([&] {
+		long long v;
+		while (!done.load()) {
+			if (queue.tryDequeue(v)) {
+				sum += v;
+				dequeued++;
+			}
+			else {
+				this_thread::yield();
+			}
+		}
+	});
+	for (int b = 0; b < CHURN; b += BATCH) {
+		vector<thread> batch;
+		for (int t = b; t < b + BATCH; t++) {
+			batch.emplace_back([&, t] {
+				try {
+					long long v;
+					for (int i = 0; i < EACH; i++) {
+						queue.enqueue(static_cast<long long>(t) * EACH + i);
+						if (i % 2 == 1 && queue.tryDequeue(v)) {
+							sum += v;
+							dequeued++;
+						}
+					}
+				}
+				catch (const exception &) {
+					failed = true;	// no hazard pointer record left for the thread
+				}
+			});
+		}
+		for (thread & t : batch) { t.join(); }
+	}
+	done = true;
+	consumer.join();
+	long long v;
+	while (queue.tryDequeue(v)) {
+		sum += v;
+		dequeued++;
+	}
+	n = static_cast<long long>(CHURN) * EACH;
+	report("Short-lived threads: count and sum", !failed && dequeued == n && sum == n * (n - 1) / 2);
+	cout << "\n";
+}
+
+// ---------------------- Check of multi-buffer SHA256 ---------------------------
+
+// PostCondition: hash256_multi and the miner midstate batches give the same digests as
+//                hash256 for every implementation the cpu supports
+void testMultiBufferHashing()
+{
+	cout << " -- Multi-buffer SHA256 --\n";
+	const char * names[] = { "scalar", "sse2", "avx2", "shani" };
+	picosha2::multi_impl original = picosha2::get_multi_impl();
+
+	// messages of lengths either side of the 55/56 and 64 byte padding boundaries
+	vector<string> messages;
+	for (int len = 0; len < 200; len += (len < 130 ? 1 : 7)) {
+		string m;
+		for (int i = 0; i < len; i++) { m += static_cast<char>('a' + (i * 7 + len) % 26); }
+		messages.push_back(m);
+	}
+	const string prefix = "[ (bank->aiden : 100.00) ]0000a1b2c3d4e5f6previous-hash-of-block1792197409";
+
+	for (int impl = 0; impl <= static_cast<int>(picosha2::multi_impl::shani); impl++) {
+		picosha2::multi_impl m = static_cast<picosha2::multi_impl>(impl);
+		if (!picosha2::is_multi_impl_supported(m)) {
+			cout << names[impl] << ": not supported by this cpu\n";
+			continue;
+		}
+		picosha2::set_multi_impl(m);
+		bool same = true;
+
+		// batches of every size up to and beyond the number of lanes
+		for (size_t first = 0; first < messages.size(); first += 3) {
+			size_t n = min(messages.size() - first, 1 + first % 11);
+			vector<const picosha2::byte_t *> data(n);
+			vector<size_t> lengths(n);
+			for (size_t i = 0; i < n; i++) {
+				data[i] = reinterpret_cast<const picosha2::byte_t *>(messages[first + i].data());
+				lengths[i] = messages[first + i].size();
+			}
+			vector<picosha2::byte_t> digests(n * picosha2::k_digest_size);
+			picosha2::hash256_multi(data.data(), lengths.data(), n, digests.data());
+			for (size_t i = 0; i < n; i++) {
+				string expected = picosha2::hash256_hex_string(messages[first + i]);
+				same = same && picosha2::bytes_to_hex_string(digests.begin() + i * picosha2::k_digest_size,
+					digests.begin() + (i + 1) * picosha2::k_digest_size) == expected;
+			}
+		}
+
+		// midstate after a prefix with nonce tails as hashed when mining
+		MidstateHasher midstate(prefix);
+		for (int start = 0; start < 1000; start += static_cast<int>(picosha2::k_multi_lanes)) {
+			string tails[picosha2::k_multi_lanes];
+			for (size_t i = 0; i < picosha2::k_multi_lanes; i++) {
+				tails[i] = encodeNonce(start + static_cast<int>(i), (start % 16 == 0) ? NonceEncoding::Binary32 : NonceEncoding::Decimal);
+			}
+			picosha2::byte_t digests[picosha2::k_multi_lanes * picosha2::k_digest_size];
+			midstate.hashBatch(tails, picosha2::k_multi_lanes, digests);
+			for (size_t i = 0; i < picosha2::k_multi_lanes; i++) {
+				same = same && picosha2::bytes_to_hex_string(digests + i * picosha2::k_digest_size,
+					digests + (i + 1) * picosha2::k_digest_size) == picosha2::hash256_hex_string(prefix + tails[i]);
+			}
+		}
+		report(names[impl], same);
+	}
+	picosha2::set_multi_impl(original);
 	cout << "\n";
 }
 
 // ------------------------------- Demo Of the BlockChain Class -----------------------------
 
+// PostCondition: readers running alongside a miner (with concurrent readers enabled)
+//                only ever see a valid chain and a ledger matching it
+void testReadersWhileMining()
+{
+	cout << " -- Readers while mining --\n";
+	const int BLOCKS = 20, READERS = 3;
+	BlockChain chain;
+	chain.setDifficultyBits(4);
+	chain.setConcurrentReaders(true);
+	chain.setConcurrentInbox(true);
+
+	atomic<bool> done{ false }, consistent{ true }, growing{ true };
+	atomic<int> reads{ 0 };
+
+	// producer submitting transactions through the inbox
+	thread producer([&] {
+		for (int i = 0; i < 2 * BLOCKS; i++) {
+			chain.addTransaction(Transaction("bank", "user" + to_string(i % 10), 1.0));
+		}
+	});
+
+	// readers, the miner is only ever paid so its balance never falls
+	vector<thread> readers;
+	for (int r = 0; r < READERS; r++) {
+		readers.emplace_back([&] {
+			auto last = chain.getBalanceOfAddress("miner1");
+			while (!done.load()) {
+				auto balance = chain.getBalanceOfAddress("miner1");
+				auto balances = chain.getBalances();
+				auto snapshot = balances.count("miner1") ? balances["miner1"] : 0;
+				if (balance < last || snapshot < balance) { growing = false; }
+				last = snapshot;
+				if (!chain.isChainValid() || !chain.verifyBalances() || chain.toString().empty()) {
+					consistent = false;
+				}
+				reads++;
+			}
+		});
+	}
+
+	// this thread mines until enough blocks have been added
+	int mined = 0;
+	while (mined < BLOCKS) {
+		if (chain.minerGenerateBlock("miner1")) {
+			mined++;
+		}
+		else {
+			this_thread::yield();
+		}
+	}
+	done = true;
+	producer.join();
+	for (thread & t : readers) { t.join(); }
+
+	report("Chain valid and ledger consistent for every read",
+		consistent && chain.isChainValid() && chain.verifyBalances());
+	report("Miner balance never decreases", growing);
+	cout << mined << " blocks mined while readers made " << reads << " reads\n";
+
+	// without concurrent readers lookups read the ledger directly, so more threads than
+	// HazardPointers::MAXTHREADS may look up balances at once
+	BlockChain plain;
+	plain.addTransaction(Transaction("bank", "user", 1.0));
+	plain.addTransaction(Transaction("bank", "user", 2.0));
+	plain.minerGenerateBlock("miner1");
+	atomic<bool> start{ false };
+	atomic<int> correct{ 0 };
+	vector<thread> lookups;
+	for (int i = 0; i < 2 * HazardPointers::MAXTHREADS; i++) {
+		lookups.emplace_back([&] {
+			while (!start.load()) { this_thread::yield(); }
+			try {
+				if (plain.getBalanceOfAddress("user") == 300) { correct++; }
+			}
+			catch (const exception &) {}
+		});
+	}
+	start = true;
+	for (thread & t : lookups) { t.join(); }
+	report("Plain lookups from many threads", correct == 2 * HazardPointers::MAXTHREADS);
+	cout << "\n";
+}
+
 void blockChainDemo() {
 
 	// create chain with initial bank balance and proof of work difficulty
@@ -226,9 +993,9 @@ void blockChainDemo() {
 	std::cout << "\n" << chain << "\n";
 
 	std::cout << "------- Balances -------\n";
-	std::cout << "Balance of Miner1: " << chain.getBalanceOfAddress("miner1") << std::endl;
-	std::cout << "Balance of Miner2: " << chain.getBalanceOfAddress("miner2") << std::endl;
-	std::cout << "Balance of aiden: " << chain.getBalanceOfAddress("aiden") << std::endl;
+	std::cout << "Balance of Miner1: " << formatCents(chain.getBalanceOfAddress("miner1")) << std::endl;
+	std::cout << "Balance of Miner2: " << formatCents(chain.getBalanceOfAddress("miner2")) << std::endl;
+	std::cout << "Balance of aiden: " << formatCents(chain.getBalanceOfAddress("aiden")) << std::endl;
 
 }
 
@@ -243,7 +1010,21 @@ int main() {
 	Q1d();
 
 	//Q2,3,4
-	//testListSetOperations();
+	testListSetOperations();
+
+	// Alternative Lists
+	testUnrolledLinkedList();
+	testSkipList();
+	testDList();
+
+	// Lock-free queue and hazard pointers
+	testConcurrentQueue();
+
+	// SHA256 used by the miner
+	testMultiBufferHashing();
+
+	// Readers of the BlockChain while a block is mined
+	testReadersWhileMining();
 
 	// Optional Q5
 	//blockChainDemo();